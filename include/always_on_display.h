@@ -0,0 +1,61 @@
+#ifndef ALWAYS_ON_DISPLAY_H
+#define ALWAYS_ON_DISPLAY_H
+
+#include <Arduino.h>
+#include "esp_timer.h"
+#include "lcd_config.h"
+
+// Low-power always-on clock. Suspends the LVGL pipeline, restricts the SH8601
+// to a partial area in idle mode and renders HH:MM into a 1-bpp bitmap that is
+// expanded to RGB565 a few rows at a time while flushing. Everything but the
+// minute timer runs on the UI task, so exit() never races an update.
+class AlwaysOnDisplay {
+private:
+    static const int REGION_WIDTH = EXAMPLE_LCD_H_RES;
+    static const int REGION_HEIGHT = 64;
+    static const int REGION_Y = ((EXAMPLE_LCD_V_RES - REGION_HEIGHT) / 2) & ~1;  // Panel needs even rows
+    static const int BITMAP_STRIDE = REGION_WIDTH / 8;
+    static const int BITMAP_BYTES = BITMAP_STRIDE * REGION_HEIGHT;
+    static const int CHUNK_ROWS = 4;                                            // Rows expanded per transfer
+    static const uint16_t FG_COLOR = 0xFFFF;                                    // Pure colours survive idle mode
+    static const uint16_t BG_COLOR = 0x0000;
+    static const uint32_t CMD_OVERHEAD_BYTES = 20;                              // CASET + RASET + RAMWR per transfer
+    static const uint32_t TRANSFER_TIMEOUT_MS = 50;
+
+    static bool active;
+    static uint8_t* bitmap;
+    static uint8_t* lastBitmap;
+    static uint16_t* lineBuf[2];
+    static esp_timer_handle_t timer;
+    static volatile bool updateDue;
+
+    // Statistics
+    static size_t bytesReleased;
+    static size_t bytesAllocated;
+    static size_t heapBefore;       // Free internal heap, measured before entering
+    static size_t heapActive;       // ... and once the clock's buffers are allocated
+    static uint32_t busBytes;
+    static uint32_t updates;
+    static uint32_t lastUpdateUs;   // Render and flush, DMA included
+    static uint32_t maxUpdateUs;
+    static unsigned long enteredAt;
+
+    static bool allocBuffers();
+    static void freeBuffers();
+    static void renderTime();
+    static void drawDigit(int x, int y, uint8_t segments);
+    static void fillRect(int x, int y, int w, int h);
+    static void flushRegion(bool full);
+    static void scheduleNextUpdate();
+    static void onTimer(void* arg);
+
+public:
+    // UI task
+    static bool enter();
+    static void exit();
+    static void service();   // Once per scheduler pass: redraws when the minute timer fired
+    static bool isActive() { return active; }
+    static void printStats();
+};
+
+#endif // ALWAYS_ON_DISPLAY_H
@@ -2,39 +2,191 @@
 #define APP_MANAGER_H
 
 #include "base_app.h"
-
-// Node for circular linked list of apps
-struct AppNode {
-    BaseApp* app;
-    AppNode* next;
-    
-    AppNode(BaseApp* a) : app(a), next(nullptr) {}
-};
+#include <ArduinoJson.h>
 
 class AppManager {
+public:
+    static const int MAX_APPS = 16;
+    static const int DEFAULT_RESIDENT_SCREENS = 3;   // Screens kept built at once
+    static const uint32_t BACKGROUND_TASK_STACK = 4096;
+    static const UBaseType_t BACKGROUND_TASK_PRIO = 1;  // Below the UI task
+    static const uint32_t DEFAULT_NAV_WINDOW_MS = 150; // Detents closer than this are coalesced
+    static const uint32_t PREFETCH_IDLE_MS = 300;      // Quiet time after a switch before prefetching
+    static const size_t DEFAULT_PREFETCH_BUDGET = 16 * 1024; // LVGL bytes prefetched screens may hold
+    static const size_t DEFAULT_WARN_BYTES = 8 * 1024;       // Per-app LVGL warning thresholds
+    static const uint16_t DEFAULT_WARN_OBJECTS = 64;
+
+    // Per-app LVGL accounting, measured each time a screen is built
+    struct MemoryStats {
+        size_t lvglBytes;      // LVGL pool taken by the screen
+        size_t peakBytes;
+        uint16_t objects;
+        uint16_t styles;       // Style references across all objects (local + shared)
+        uint32_t builds;
+        size_t warnBytes;      // 0 = no limit
+        uint16_t warnObjects;  // 0 = no limit
+        bool overLimit;
+    };
+
+    // What the MQTT status reports for one app - copied from the UI task's
+    // state whenever a screen is built, evicted or switched
+    struct MemorySnapshot {
+        const char* name;
+        BaseApp::State state;
+        size_t lvglBytes;
+        uint16_t objects;
+        uint16_t styles;
+        bool overLimit;
+    };
+
+    // Per-app CPU accounting for one update kind
+    struct UpdateStats {
+        uint32_t runs;
+        uint64_t totalUs;
+        uint32_t maxUs;
+        uint32_t overruns;
+    };
+
 private:
-    // Circular linked list of apps
-    AppNode* currentNode = nullptr;
+    // Indexed app ring - next/previous are O(1) index steps
+    BaseApp* apps[MAX_APPS] = {};
+    uint32_t lastUsed[MAX_APPS] = {};               // LRU stamps for resident screens
     int appCount = 0;
-    
+    int currentIndex = -1;
+    int residentBudget = DEFAULT_RESIDENT_SCREENS;
+    uint32_t useCounter = 0;
+
+    // Update scheduling
+    int64_t nextForegroundUs = 0;
+    int64_t nextBackgroundUs[MAX_APPS] = {};
+    UpdateStats foregroundStats[MAX_APPS] = {};
+    UpdateStats backgroundStats[MAX_APPS] = {};      // Written on the background task, under statsLock
+    mutable portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+    unsigned long statsSince = 0;
+    TaskHandle_t backgroundTaskHandle = nullptr;
+
+    // Coalesced navigation - the first detent after the knob has been still
+    // for navWindowMs switches at once; detents that follow it accumulate here
+    // and only the final destination is built once the knob settles again
+    portMUX_TYPE navLock = portMUX_INITIALIZER_UNLOCKED;
+    volatile bool navPending = false;
+    bool navLeading = false;                         // Pending detents opened a burst - commit now
+    int pendingDelta = 0;
+    int64_t lastNavUs = 0;
+    uint32_t navWindowMs = DEFAULT_NAV_WINDOW_MS;
+    lv_obj_t* navIndicator = nullptr;
+    int navIndicatorIndex = -1;
+
+    // Idle prefetch of the ring neighbours
+    bool prefetchEnabled = true;
+    size_t prefetchBudget = DEFAULT_PREFETCH_BUDGET;
+    size_t prefetchedBytes = 0;                      // Held by prefetched, not yet visited screens
+    size_t prefetchedPeakBytes = 0;
+    bool prefetched[MAX_APPS] = {};
+    int64_t lastSwitchUs = 0;
+    uint32_t prefetchBuilds = 0;
+    uint32_t prefetchHits = 0;                       // Switch landed on a prefetched screen
+    uint32_t prefetchWasted = 0;                     // Prefetched screen evicted unused
+    uint32_t residentHits = 0;                       // Switch landed on a screen kept from a visit
+    uint32_t buildMisses = 0;                        // Switch had to build the screen
+
+    // Memory accounting
+    MemoryStats memStats[MAX_APPS] = {};
+    MemorySnapshot memSnapshot[MAX_APPS] = {};       // Read from the MQTT task, under snapshotLock
+    int memSnapshotCount = 0;
+    mutable portMUX_TYPE snapshotLock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Navigation statistics
+    uint32_t navDetents = 0;
+    uint32_t navBursts = 0;
+    uint32_t navCommits = 0;                         // Switches made by navigation, leading or settled
+    uint32_t switches = 0;
+    uint32_t buildBlocks = 0;                        // Net LVGL blocks taken by screen builds
+    uint32_t evictBlocks = 0;                        // Net LVGL blocks released by evictions
+    uint64_t switchTotalUs = 0;
+    uint32_t switchMaxUs = 0;
+    uint64_t burstLatencyTotalUs = 0;
+    uint32_t burstLatencyMaxUs = 0;
+
 public:
     AppManager();
-    
-    // App registration - apps call this during their init()
+
+    // App registration - called once per app from setup(), in ring order
     void registerApp(BaseApp* app);
-    
-    // Focus management - called by encoder
+
+    // Register a fixed app table (see AppRegistry)
+    void registerApps(BaseApp* const* table, int count);
+
+    // Show the first registered app (builds only its screen)
+    void begin();
+
+    // Focus management - called by encoder from any task; the switch
+    // itself happens in update() once the knob settles
     void onEncoderChange(int direction);
-    
-    // Lifecycle
-    void update();
-    
+
+    // Hand the active app this frame's InputSnapshot (UI task, once per pass)
+    void dispatchInput();
+
+    // Switch immediately by delta apps, bypassing coalescing (UI task only)
+    void switchBy(int delta);
+
+    // Coalescing window - 0 switches on every detent
+    void setNavigationWindow(uint32_t ms) { navWindowMs = ms; }
+    uint32_t getNavigationWindow() const { return navWindowMs; }
+
+    // Lifecycle - commits settled navigation and runs the active app's view
+    // update when due; returns the ms until either is due again (UINT32_MAX if never)
+    uint32_t update();
+
+    // Start the task that runs updateBackground() for every app - after registration
+    bool startBackgroundTask();
+
+    // Prefetch - neighbours are built during idle frames within a memory budget
+    void setPrefetchEnabled(bool on) { prefetchEnabled = on; }
+    bool isPrefetchEnabled() const { return prefetchEnabled; }
+    void setPrefetchBudget(size_t bytes) { prefetchBudget = bytes; }
+    size_t getPrefetchBudget() const { return prefetchBudget; }
+
+    // Residency - number of app screens allowed to stay built
+    void setResidentScreenBudget(int screens);
+    int getResidentScreenBudget() const { return residentBudget; }
+    int getResidentScreenCount() const;
+
     // Current app access
-    BaseApp* getCurrentApp() const { return currentNode ? currentNode->app : nullptr; }
+    BaseApp* getCurrentApp() const { return currentIndex >= 0 ? apps[currentIndex] : nullptr; }
+    BaseApp* getApp(int index) const { return (index >= 0 && index < appCount) ? apps[index] : nullptr; }
+    int getCurrentIndex() const { return currentIndex; }
     int getAppCount() const { return appCount; }
-    
+
+    // Per-app LVGL memory - limits are persisted per app name
+    const MemoryStats* getMemoryStats(int index) const { return (index >= 0 && index < appCount) ? &memStats[index] : nullptr; }
+    bool setMemoryLimit(const char* appName, size_t bytes, uint16_t objects);
+    void printMemory() const;
+    void addMemoryStatus(JsonDocument& doc) const;  // For the MQTT status message - any task
+
+    // Status
+    void printStatus() const;
+    void resetStats();
+    uint32_t getSwitchCount() const { return switches; }
+    uint32_t getBuildBlocks() const { return buildBlocks; }   // Net LVGL blocks taken by screen builds
+
 private:
     void switchToCurrentApp();
+    uint32_t serviceNavigation();
+    void showNavIndicator(int index);
+    void hideNavIndicator();
+    bool trimResident(int limit, int keepIndex, int alsoKeep = -1);  // false if more than limit stay built
+    bool evictApp(int index);
+    static bool evictSlot(int index, void* ctx);
+    bool buildScreen(int index);
+    void publishMemorySnapshot();
+    void loadMemoryLimits(int index);
+    uint32_t servicePrefetch();
+    bool prefetchApp(int index, int otherNeighbour);
+    int wrapIndex(int index) const;
+    uint32_t runBackgroundUpdates();
+    static void backgroundTask(void* arg);
+    static void recordRun(UpdateStats& stats, uint32_t elapsedUs, uint32_t budgetUs);
 };
 
 // Global app manager instance
@@ -0,0 +1,81 @@
+#ifndef APP_REGISTRY_H
+#define APP_REGISTRY_H
+
+#include <tuple>
+#include <type_traits>
+#include "base_app.h"
+
+// Compile-time app list. The template argument order is the ring order and
+// every app lives in one static tuple (no heap, no registration churn).
+// AppManager keeps pointers into it and calls apps through BaseApp; what the
+// app layer costs in flash and RAM is listed by `pio run -t sizes`. Usage:
+//   typedef AppRegistry<HomeApp, ClockApp> Apps;
+//   appManager.registerApps(Apps::table(), Apps::COUNT);
+//   Apps::get<EnergyApp>().onEnergyData(doc);
+
+namespace app_registry_detail {
+
+template <int I, typename... Apps>
+struct Fill;
+
+template <int I>
+struct Fill<I> {
+    template <typename Storage> static void run(Storage&, BaseApp**) {}
+};
+
+template <int I, typename First, typename... Rest>
+struct Fill<I, First, Rest...> {
+    static_assert(std::is_base_of<BaseApp, First>::value, "AppRegistry entries must derive from BaseApp");
+
+    template <typename Storage>
+    static void run(Storage& storage, BaseApp** table) {
+        table[I] = &std::get<I>(storage);
+        Fill<I + 1, Rest...>::run(storage, table);
+    }
+};
+
+template <typename T, typename... Apps>
+struct IndexOf;
+
+template <typename T, typename... Rest>
+struct IndexOf<T, T, Rest...> {
+    static const int value = 0;
+};
+
+template <typename T, typename First, typename... Rest>
+struct IndexOf<T, First, Rest...> {
+    static const int value = 1 + IndexOf<T, Rest...>::value;
+};
+
+} // namespace app_registry_detail
+
+template <typename... Apps>
+class AppRegistry {
+    static_assert(sizeof...(Apps) > 0, "AppRegistry needs at least one app");
+
+public:
+    static const int COUNT = sizeof...(Apps);
+
+    // App pointers into static storage, in ring order
+    static BaseApp* const* table() {
+        static BaseApp* entries[COUNT] = {};
+        if (!entries[0]) {
+            app_registry_detail::Fill<0, Apps...>::run(storage, entries);
+        }
+        return entries;
+    }
+
+    // The one instance of an app, for wiring data sources to it
+    template <typename T>
+    static T& get() {
+        return std::get<app_registry_detail::IndexOf<T, Apps...>::value>(storage);
+    }
+
+private:
+    static std::tuple<Apps...> storage;
+};
+
+template <typename... Apps>
+std::tuple<Apps...> AppRegistry<Apps...>::storage;
+
+#endif // APP_REGISTRY_H
@@ -3,23 +3,57 @@
 
 #include <lvgl.h>
 #include <Arduino.h>
+#include "ui_update_queue.h"
+#include "input_frame.h"
 
 // Super simple base class for all apps
 class BaseApp {
+public:
+    // Lifecycle states - transitions are driven by AppManager only
+    //   Created   -> never shown, no screen
+    //   Active    -> screen built and loaded
+    //   Suspended -> screen built but not shown
+    //   Evicted   -> screen released to stay within the residency budget
+    enum class State : uint8_t { Created, Suspended, Active, Evicted };
+
+    // Update cadence declared by each app - both are opt-in, a period of 0
+    // (the default) means the update is never called
+    struct Schedule {
+        uint32_t foregroundPeriodMs;  // update() on the LVGL task while active
+        uint32_t backgroundPeriodMs;  // updateBackground() on the background task, shown or not
+        uint32_t budgetUs;            // Longer runs are counted as overruns
+    };
+
 protected:
     lv_obj_t* screen = nullptr;
     bool initialized = false;
+    State state = State::Created;
+    lv_group_t* group = nullptr;
+    
+    // Widgets the knob can focus and edit - add them in init(). The group
+    // lives as long as the app; deleted widgets leave it by themselves.
+    lv_group_t* inputGroup() {
+        if (!group) group = lv_group_create();
+        return group;
+    }
     
 public:
     virtual ~BaseApp() = default;
     
     // Core app lifecycle - simple and clean
-    virtual bool init() = 0;                     // Initialize app and register with AppManager
-    virtual void deinit() = 0;                   // Clean up app resources
+    virtual bool init() = 0;                     // Build the screen (called lazily by AppManager)
+    virtual void deinit() = 0;                   // Clean up app resources (also used for eviction)
     virtual lv_obj_t* createScreen() = 0;       // Create and return the LVGL screen object
     virtual void onEnter() = 0;                  // Called when app becomes active
     virtual void onExit() = 0;                   // Called when app becomes inactive
-    virtual void update() = 0;                   // Called periodically to update app logic
+    virtual void update() = 0;                   // Called periodically to update the view (LVGL task)
+    virtual void updateBackground() {}           // Data-only work, runs even while the screen is evicted (background task, never LVGL)
+    virtual Schedule getSchedule() const { return { 0, 0, 5000 }; }
+    
+    // Input since the last frame, at most once per UI pass and before LVGL
+    // renders (LVGL task) - apply it to the model and widgets in one go
+    virtual void onInput(const InputSnapshot& input) {}
+    virtual bool usesKnob() const { return false; }  // Focus mode sends raw detents to onInput()
     
     // App metadata
     virtual const char* getName() = 0;          // App name for logging
@@ -27,6 +61,51 @@ public:
     // Screen management
     virtual lv_obj_t* getScreen() { return screen; }
     virtual bool isInitialized() const { return initialized; }
+    lv_group_t* getInputGroup() const { return group; }  // nullptr = the knob only switches apps
+
+    // State transitions - resume/suspend never allocate or rebuild
+    State getState() const { return state; }
+
+    bool activate() {
+        if (state == State::Active) return true;
+        if (!initialized && !init()) return false;  // Created/Evicted -> build once
+        state = State::Active;
+        onEnter();
+        return true;
+    }
+
+    // Build the screen without showing it (idle prefetch) - Created/Evicted -> Suspended
+    bool prefetch() {
+        if (initialized) return true;
+        if (!init()) return false;
+        state = State::Suspended;
+        return true;
+    }
+
+    void suspend() {
+        if (state != State::Active) return;
+        onExit();
+        state = State::Suspended;
+    }
+
+    // Only a suspended screen can go; returns false and keeps it otherwise
+    bool evict() {
+        if (state != State::Suspended) return false;
+        UiUpdateQueue::purge(screen);  // Nothing may land on widgets that are about to go
+        deinit();
+        state = State::Evicted;
+        return true;
+    }
+
+    static const char* stateName(State s) {
+        switch (s) {
+            case State::Created:   return "created";
+            case State::Suspended: return "suspended";
+            case State::Active:    return "active";
+            case State::Evicted:   return "evicted";
+        }
+        return "?";
+    }
 };
 
 #endif // BASE_APP_H
@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include "esp_err.h"
+#include "knob_decoder.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -32,6 +33,37 @@ extern "C"
         KNOB_NONE,      /*!< EVENT: No event */
     } knob_event_t;
 
+    /**
+     * @brief Knob backends
+     *
+     */
+    typedef enum
+    {
+        KNOB_BACKEND_TIMER = 0, /*!< Sample both pins from a periodic esp_timer */
+        KNOB_BACKEND_PCNT,      /*!< Count pulses in the PCNT peripheral (two units per knob), wake on edges */
+    } knob_backend_t;
+
+    /**
+     * @brief How the timer backend reads the pins
+     *
+     */
+    typedef enum
+    {
+        KNOB_SAMPLING_BATCHED = 0, /*!< One input register read per tick for every knob */
+        KNOB_SAMPLING_PER_PIN,     /*!< gpio_get_level() for each pin of each knob */
+    } knob_sampling_t;
+
+    /**
+     * @brief Timer tick cost, in nanoseconds per tick
+     *
+     */
+    typedef struct
+    {
+        uint32_t per_pin_ns; /*!< KNOB_SAMPLING_PER_PIN */
+        uint32_t batched_ns; /*!< KNOB_SAMPLING_BATCHED while a knob is moving */
+        uint32_t idle_ns;    /*!< KNOB_SAMPLING_BATCHED with every knob still */
+    } knob_bench_t;
+
     /**
      * @brief Knob config
      *
@@ -40,6 +72,8 @@ extern "C"
     {
         uint8_t gpio_encoder_a; /*!< Encoder Pin A */
         uint8_t gpio_encoder_b; /*!< Encoder Pin B */
+        knob_backend_t backend; /*!< Backend, the timer if left zero */
+        knob_decoder_mode_t decoder; /*!< Pin transition table, bidirectional switch if left zero */
     } knob_config_t;
 
     /**
@@ -117,7 +151,118 @@ extern "C"
     esp_err_t iot_knob_clear_count_value(knob_handle_t knob_handle);
 
     /**
-     * @brief resume knob timer, if knob timer is stopped. Make sure iot_knob_create() is called before calling this API.
+     * @brief Get the backend a knob is running on
+     *
+     * @param knob_handle A knob handle
+     * @return knob_backend_t Backend, ESP_ERR_INVALID_ARG for an invalid handle
+     */
+    knob_backend_t iot_knob_get_backend(knob_handle_t knob_handle);
+
+    /**
+     * @brief Get decoder statistics
+     *
+     * @param knob_handle A knob handle
+     * @param accepted Steps counted
+     * @param rejected Edges discarded as contact bounce
+     * @param invalid Pin transitions the decoder table does not allow
+     *
+     * @return
+     *         - ESP_OK  Success
+     *         - ESP_ERR_INVALID_ARG Invalid handle
+     */
+    esp_err_t iot_knob_get_stats(knob_handle_t knob_handle, uint32_t *accepted, uint32_t *rejected, uint32_t *invalid);
+
+    /**
+     * @brief Get the accelerated count, which moves by several steps per detent on a fast spin
+     *
+     * @param knob_handle A knob handle
+     *
+     * @return int accelerated count value, ESP_ERR_INVALID_ARG for an invalid handle
+     */
+    int iot_knob_get_accel_count_value(knob_handle_t knob_handle);
+
+    /**
+     * @brief Get the accelerated steps of the most recent detent, signed
+     *
+     * Meant to be read from a KNOB_LEFT / KNOB_RIGHT callback.
+     *
+     * @param knob_handle A knob handle
+     *
+     * @return int steps, right positive; ESP_ERR_INVALID_ARG for an invalid handle
+     */
+    int iot_knob_get_last_delta(knob_handle_t knob_handle);
+
+    /**
+     * @brief Get the smoothed knob speed
+     *
+     * @param knob_handle A knob handle
+     *
+     * @return uint32_t detents per second, 0 when the knob is still; ESP_ERR_INVALID_ARG for an invalid handle
+     */
+    uint32_t iot_knob_get_velocity(knob_handle_t knob_handle);
+
+    /**
+     * @brief Set the acceleration curve
+     *
+     * @param knob_handle A knob handle
+     * @param curve New curve
+     *
+     * @return
+     *         - ESP_OK  Success
+     *         - ESP_ERR_INVALID_ARG Invalid handle or curve
+     */
+    esp_err_t iot_knob_set_accel_curve(knob_handle_t knob_handle, const knob_accel_curve_t *curve);
+
+    /**
+     * @brief Get the acceleration curve
+     *
+     * @param knob_handle A knob handle
+     * @param curve Filled with the current curve
+     *
+     * @return
+     *         - ESP_OK  Success
+     *         - ESP_ERR_INVALID_ARG Invalid handle or curve
+     */
+    esp_err_t iot_knob_get_accel_curve(knob_handle_t knob_handle, knob_accel_curve_t *curve);
+
+    /**
+     * @brief Choose how the timer backend reads the pins, batched by default
+     *
+     * @param sampling Sampling mode
+     *
+     * @return
+     *         - ESP_OK  Success
+     *         - ESP_ERR_INVALID_ARG Unknown mode
+     */
+    esp_err_t iot_knob_set_sampling(knob_sampling_t sampling);
+
+    /**
+     * @brief Get the timer backend's sampling mode
+     *
+     * @return knob_sampling_t Sampling mode
+     */
+    knob_sampling_t iot_knob_get_sampling(void);
+
+    /**
+     * @brief Measure the timer tick for a number of knobs in each sampling mode
+     *
+     * Runs the tick on scratch knobs wired to the first registered knob's
+     * pins, so registered knobs and their callbacks are not touched.
+     *
+     * @param knobs Scratch knobs to sample per tick
+     * @param ticks Ticks to average over
+     * @param result Filled with the cost per tick
+     *
+     * @return
+     *         - ESP_OK  Success
+     *         - ESP_ERR_INVALID_ARG Invalid count or result pointer
+     *         - ESP_ERR_INVALID_STATE No knob created yet
+     *         - ESP_ERR_NO_MEM Scratch knobs could not be allocated
+     */
+    esp_err_t iot_knob_bench_tick(int knobs, int ticks, knob_bench_t *result);
+
+    /**
+     * @brief resume knob timer, if knob timer is stopped, and any stopped pulse counters. Make sure iot_knob_create() is called before calling this API.
      *
      * @return
      *     - ESP_OK on success
@@ -126,7 +271,7 @@ extern "C"
     esp_err_t iot_knob_resume(void);
 
     /**
-     * @brief stop knob timer, if knob timer is running. Make sure iot_knob_create() is called before calling this API.
+     * @brief stop knob timer, if knob timer is running, and pause any pulse counters. Make sure iot_knob_create() is called before calling this API.
      *
      * @return
      *     - ESP_OK on success
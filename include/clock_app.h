@@ -3,7 +3,22 @@
 
 #include "base_app.h"
 
+// Kitchen timer: in Focus mode each accelerated knob step adds or takes a
+// minute and the key starts or stops the countdown
 class ClockApp : public BaseApp {
+private:
+    static const int MAX_TIMER_S = 180 * 60;
+
+    lv_obj_t* timerLabel = nullptr;
+
+    // Model - survives eviction, init() renders it into a rebuilt screen
+    int timerS = 0;            // Set time, or what was left when stopped
+    bool running = false;
+    int64_t endUs = 0;         // When a running countdown reaches zero
+
+    int remainingS() const;
+    void render();
+
 public:
     bool init() override;
     void deinit() override;
@@ -11,6 +26,9 @@ public:
     void onEnter() override;
     void onExit() override;
     void update() override;
+    Schedule getSchedule() const override { return { running ? 1000u : 0u, 0, 2000 }; }
+    void onInput(const InputSnapshot& input) override;
+    bool usesKnob() const override { return true; }
     const char* getName() override { return "Clock"; }
 };
 
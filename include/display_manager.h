@@ -5,26 +5,62 @@
 #include <lvgl.h>
 #include "lcd_driver.h"
 
+// Frame timing accumulated since the last takeFrameStats() call
+struct FrameStats {
+    uint32_t frames = 0;
+    uint32_t renderUs = 0;   // Time spent rendering, excluding flush callbacks
+    uint32_t flushUs = 0;    // Flush start to lv_disp_flush_ready(), DMA transfer included
+    uint32_t pixels = 0;     // Pixels redrawn
+};
+
 // High-level display system manager for LVGL
 class DisplayManager {
 private:
     static lv_disp_draw_buf_t draw_buf;
-    static lv_color_t buf1[EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT];
-    static lv_color_t buf2[EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT];
+    static lv_color_t* buf1;
+    static lv_color_t* buf2;
+    // Stands in for the draw buffers while suspended: rounder_cb() widens every
+    // area to an even pair of rows, so LVGL needs at least two lines to make progress
+    static const size_t IDLE_BUF_LINES = 2;
+    static const uint32_t FLUSH_WAIT_MS = 100;
+    static lv_color_t idleBuf[EXAMPLE_LCD_H_RES * IDLE_BUF_LINES];
     static lv_disp_drv_t disp_drv;
     static lv_indev_drv_t indev_drv;
+    static bool renderingSuspended;
+    
+    // Frame timing
+    static FrameStats frameStats;
+    static uint32_t pendingFlushUs;     // CPU time inside flush_cb, taken out of renderUs
+    
+    static bool allocDrawBuffers();
+    static void freeDrawBuffers();
+    
+    // LVGL display driver hooks
+    static void flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
+    static void monitor_cb(lv_disp_drv_t *disp, uint32_t time, uint32_t px);
     
 public:
+    static const size_t DRAW_BUF_PIXELS = EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT;
+    
     // System initialization
     static bool initLVGL();
     static bool initDisplay();
     static bool initInput();
     
     // System management
-    static void handleLVGLTasks();
+    static uint32_t handleLVGLTasks();  // Returns ms until the next LVGL timer is due
     static void shutdown();
     static void restart();
     
+    // Render pipeline suspension - frees the draw buffers, returns bytes released
+    // (0 and nothing suspended if a flush could not be drained)
+    static size_t suspendRendering();
+    static bool resumeRendering();
+    static bool isRenderingSuspended() { return renderingSuspended; }
+    
+    // Frame timing - returns the totals since the previous call and resets them
+    static FrameStats takeFrameStats();
+    
     // Convenience methods
     static int getScreenWidth() { return LcdDriver::getScreenWidth(); }
     static int getScreenHeight() { return LcdDriver::getScreenHeight(); }
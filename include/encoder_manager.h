@@ -3,36 +3,100 @@
 
 #include <Arduino.h>
 #include "bidi_switch_knob.h"
+#include "spsc_ring.h"
 
-// Simple callback type - just direction
-typedef void (*EncoderChangeCallback)(int direction);  // -1 for left, +1 for right
+// Simple callback type - net detents of one batch
+typedef void (*EncoderChangeCallback)(int direction);  // < 0 for left, > 0 for right
+
+// One detent, as recorded by the knob driver
+struct EncoderEvent {
+    uint32_t timeUs;       // esp_timer time of the detent
+    int8_t direction;      // -1 left, +1 right
+    int8_t steps;          // Accelerated steps, signed like direction
+    uint16_t velocity;     // Detents per second at the time
+};
+
+// Everything that arrived between two dispatcher wakeups
+struct EncoderBatch {
+    int delta;             // Net detents, right positive
+    int steps;             // Net accelerated steps
+    uint16_t events;       // Detents in the batch
+    uint16_t velocity;     // Speed at the newest detent
+    uint32_t firstUs;      // Oldest detent
+    uint32_t lastUs;       // Newest detent
+};
+
+// Batch listener - runs on the encoder task, so it must not touch LVGL
+// (record the input, or post through UiUpdateQueue)
+typedef void (*EncoderBatchListener)(const EncoderBatch& batch, void* ctx);
 
 // Simple Encoder Manager - Volos style
 class EncoderManager {
 private:
     // Volos encoder system core
-    static EventGroupHandle_t knob_even_;
     static knob_handle_t s_knob;
-    static SemaphoreHandle_t mutex;
+    static TaskHandle_t dispatchTask;
     
     // Simple callback
     static EncoderChangeCallback changeCallback;
     
+    // Batch listeners - register during setup, before input arrives
+    static const int MAX_LISTENERS = 4;
+    struct Listener {
+        EncoderBatchListener fn;
+        void* ctx;
+    };
+    static Listener listeners[MAX_LISTENERS];
+    static int listenerCount;
+    
+    // Detents from the knob driver's task to the dispatcher task
+    static const uint32_t EVENT_RING_SIZE = 64;
+    static const uint32_t DISPATCH_STACK = 2560;
+    static SpscRing<EncoderEvent, EVENT_RING_SIZE> events;
+    static void pushEvent(int direction);
+    
+    // Dispatcher statistics
+    static uint32_t consumed;
+    static uint32_t batches;
+    static uint32_t maxBatch;
+    static uint32_t maxQueueUs;
+    static uint64_t totalLatencyUs;
+    static uint64_t busyUs;
+    
     // Volos-style callback functions
     static void _knob_left_cb(void *arg, void *data);
     static void _knob_right_cb(void *arg, void *data);
-    static void user_encoder_loop_task(void *arg);
+    static void dispatchLoop(void *arg);
+    static void deliver(const EncoderBatch& batch);
+    static void loadAccelCurve();
     
 public:
     // Core functionality
     static bool begin();
     static void end();
     
-    // Register callback (default to AppManager)
+    // Register callback (default to AppManager) - called once per batch on
+    // the encoder task with the batch's net detents
     static void setChangeCallback(EncoderChangeCallback callback);
     
+    // Further batch listeners
+    static bool addListener(EncoderBatchListener listener, void* ctx = nullptr);
+    static void removeListener(EncoderBatchListener listener, void* ctx = nullptr);
+    
+    static void resetStats();
+    
+    // Speed and acceleration
+    static uint32_t getVelocity();             // Detents per second, 0 when still
+    static int getCount();                     // Net detents since start
+    static int getAcceleratedCount();
+    static bool setAccelCurve(uint16_t startDps, uint16_t fullDps, uint8_t maxMult);
+    
     // Status
     static bool isInitialized();
+    static void printStatus();
+    
+    // Timer tick cost against knob count, per-pin reads vs one register read
+    static void runTickBenchmark();
 };
 
 #endif // ENCODER_MANAGER_H
@@ -2,8 +2,21 @@
 #define ENERGY_APP_H
 
 #include "base_app.h"
+#include "ui_update_queue.h"
+#include <ArduinoJson.h>
 
 class EnergyApp : public BaseApp {
+private:
+    volatile UiHandle readout = UI_HANDLE_NONE;   // Value label while the screen is built, posted to through the queue
+
+    // Model, kept while the screen is evicted: the MQTT task stores the latest
+    // sample, updateBackground() folds it into the text, init() renders it
+    portMUX_TYPE modelLock = portMUX_INITIALIZER_UNLOCKED;
+    float power = 0;
+    float energy = 0;
+    bool fresh = false;                           // Sample not folded yet
+    char text[32] = "--";
+
 public:
     bool init() override;
     void deinit() override;
@@ -11,7 +24,12 @@ public:
     void onEnter() override;
     void onExit() override;
     void update() override;
+    void updateBackground() override;
+    Schedule getSchedule() const override { return { 0, 1000, 2000 }; }
     const char* getName() override { return "Energy"; }
+    
+    // MQTT task - energy/+ messages
+    void onEnergyData(const JsonDocument& doc);
 };
 
 #endif // ENERGY_APP_H
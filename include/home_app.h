@@ -5,7 +5,7 @@
 
 class HomeApp : public BaseApp {
 public:
-    // Constructor - registers with AppManager
+    // Constructor - registered with AppManager from setup()
     HomeApp();
     
     // Core app lifecycle
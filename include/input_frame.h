@@ -0,0 +1,93 @@
+#ifndef INPUT_FRAME_H
+#define INPUT_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "touch_gesture.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C entry point for the touch driver - UI task, once per pointer read
+void input_frame_touch(bool pressed, int16_t x, int16_t y);
+
+// C entry point for the gesture recognizer - touch task, or UI task when polling
+void input_frame_gesture(const touch_gesture_event_t* event);
+
+#ifdef __cplusplus
+}
+
+#include <Arduino.h>
+#include "encoder_manager.h"
+
+// Everything that arrived for the active app since the previous frame
+struct InputSnapshot {
+    // Knob - only for apps that take it raw (BaseApp::usesKnob) in Focus mode
+    int knobDelta;            // Net detents, right positive
+    int knobSteps;            // Net accelerated steps
+    uint16_t knobDetents;     // Detents folded into this frame
+    uint16_t knobVelocity;    // Detents per second at the newest detent
+    uint8_t keyPresses;       // Encoder key clicks (background tap)
+
+    // Touch - anywhere on the screen, widgets still get their own events
+    bool touching;            // Finger down at the end of the frame
+    uint8_t touchDowns;       // Press edges within the frame
+    uint8_t touchUps;         // Release edges within the frame
+    int16_t touchX;           // Last reported point
+    int16_t touchY;
+    int16_t touchDx;          // Movement while pressed within the frame
+    int16_t touchDy;
+
+    // Gestures - recognised in the touch driver (touch_gesture.h)
+    uint8_t taps;             // Every tap, including both halves of a double tap
+    uint8_t doubleTaps;
+    uint8_t longPresses;
+    uint8_t swipe;            // touch_swipe_dir_t of the frame's last swipe, TOUCH_SWIPE_NONE if none
+    int rotateSteps;          // Net bezel rotation steps, clockwise positive
+    int32_t rotateAngle;      // Net bezel rotation, 65536 to a turn
+
+    uint32_t sinceUs;         // Time since the previous delivered snapshot
+
+    bool hasKnob() const { return knobDelta != 0 || keyPresses != 0; }
+    bool hasTouch() const { return touchDowns || touchUps || touchDx || touchDy || hasGesture(); }
+    bool hasGesture() const { return taps || longPresses || swipe || rotateAngle; }
+};
+
+// Accumulates knob detents, key presses, touch movement and gestures between frames
+// and hands the active app one InputSnapshot per UI pass, before LVGL
+// renders - turning a value by 12 detents within a frame is one onInput()
+// call, one model update and one redraw.
+class InputFrame {
+private:
+    static InputSnapshot pending;
+    static bool touchWasDown;
+    static int16_t lastX, lastY;
+    static int64_t lastDeliveryUs;
+    static portMUX_TYPE lock;
+
+    // Statistics
+    static uint32_t knobBatches;
+    static uint32_t touchMoves;
+    static uint32_t gestures;
+    static uint32_t snapshots;
+    static uint32_t maxDetents;
+
+public:
+    // Producers - any task except ISRs
+    static void addKnob(const EncoderBatch& batch);
+    static void addKeyPress();
+    static void addTouch(bool pressed, int16_t x, int16_t y);  // UI task
+    static void addGesture(const touch_gesture_event_t& event);
+    static void discardKnob();                                   // Mode or app changed
+
+    // UI task, once per pass: false if nothing arrived since the last frame
+    static bool take(InputSnapshot& out);
+
+    static void printStats();
+    static void resetStats();
+};
+
+#endif // __cplusplus
+
+#endif // INPUT_FRAME_H
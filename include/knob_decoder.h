@@ -0,0 +1,128 @@
+/*
+ * Knob step decoder shared by the knob backends.
+ *
+ * Pure C with no ESP-IDF dependencies so it can be compiled and exercised
+ * on the host. The timer backend feeds it sampled pin levels, the pulse
+ * counter backend feeds it every edge interrupt: the levels, the time and
+ * the falling edges counted since the last one.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define KNOB_DECODER_DEBOUNCE_TICKS 2      /*!< Samples a pin state must hold to count (timer backend) */
+#define KNOB_DECODER_REARM_US       300    /*!< Quiet time before a line's next fall is a new detent (counter backend) */
+#define KNOB_DECODER_IDLE_US        300000 /*!< A pause this long ends a spin; velocity restarts at zero */
+#define KNOB_DECODER_MAX_DPS        1000   /*!< Velocity clamp, detents per second */
+
+    /**
+     * @brief Pin transition tables
+     *
+     */
+    typedef enum
+    {
+        KNOB_DECODER_BIDI = 0,   /*!< Bidirectional switch: A pulses low per detent right, B per detent left */
+        KNOB_DECODER_QUADRATURE, /*!< Gray-code quadrature, four transitions per detent */
+    } knob_decoder_mode_t;
+
+    /**
+     * @brief Acceleration curve
+     *
+     * Below start_dps every detent is one step. The multiplier then rises
+     * linearly to max_mult at full_dps and stays there.
+     */
+    typedef struct
+    {
+        uint16_t start_dps; /*!< Detents per second where acceleration begins */
+        uint16_t full_dps;  /*!< Detents per second where it reaches max_mult */
+        uint8_t max_mult;   /*!< Steps per detent at full speed */
+    } knob_accel_curve_t;
+
+#define KNOB_ACCEL_CURVE_DEFAULT {10, 30, 5}
+
+    /**
+     * @brief Decoder state for one knob
+     *
+     */
+    typedef struct
+    {
+        knob_decoder_mode_t mode;
+        knob_accel_curve_t accel;
+
+        uint8_t state;            /*!< Committed pin state, (A << 1) | B */
+        uint8_t candidate;        /*!< Pin state waiting out the debounce */
+        uint8_t stable_cnt;       /*!< Samples the candidate has held */
+        int8_t sub_steps;         /*!< Table steps since the pins left the rest state */
+        uint8_t lines_seen;       /*!< Lines with an edge so far, (A << 1) | B (counter backend) */
+        uint32_t line_edge_us[2]; /*!< Last edge on A and on B (counter backend) */
+        uint8_t line_press[2];    /*!< Press state of A and of B (counter backend) */
+
+        uint32_t last_detent_us;  /*!< Time of the last detent */
+        int8_t last_dir;          /*!< Direction of the last detent, 0 before the first */
+        uint32_t velocity_q4;     /*!< Smoothed detents per second, 4 fractional bits */
+        int8_t last_delta;        /*!< Accelerated steps of the last detent, signed */
+
+        int count;                /*!< Net detents, right positive */
+        int accel_count;          /*!< Net accelerated steps */
+        uint32_t accepted;        /*!< Detents counted */
+        uint32_t rejected;        /*!< Pin states or edges discarded as bounce */
+        uint32_t invalid;         /*!< Transitions the table does not allow */
+    } knob_decoder_t;
+
+    /**
+     * @brief Reset a decoder to the given idle levels with the default curve
+     */
+    void knob_decoder_init(knob_decoder_t *dec, knob_decoder_mode_t mode, uint8_t level_a, uint8_t level_b);
+
+    /**
+     * @brief Replace the acceleration curve
+     */
+    void knob_decoder_set_accel(knob_decoder_t *dec, const knob_accel_curve_t *curve);
+
+    /**
+     * @brief Feed one sample of both lines (timer backend)
+     *
+     * @return +1 for a detent right, -1 for a detent left, 0 otherwise
+     */
+    int knob_decoder_sample(knob_decoder_t *dec, uint8_t level_a, uint8_t level_b, uint32_t now_us);
+
+    /**
+     * @brief True when sampling unchanged levels again cannot change the decoder (timer backend)
+     */
+    bool knob_decoder_idle(const knob_decoder_t *dec);
+
+    /**
+     * @brief Feed one edge interrupt (counter backend, bidirectional switch only)
+     *
+     * A line's first falling edge after it has been quiet for
+     * KNOB_DECODER_REARM_US is a detent, reported on the spot. Every other
+     * edge until the line goes quiet again is bounce or the release, so the
+     * decoder never waits for the lines to settle before counting.
+     *
+     * @param falls Falling edges counted since the last call, A positive, B negative
+     * @param now_us Time of the interrupt
+     *
+     * @return +1 for a detent right, -1 for a detent left, 0 otherwise
+     */
+    int knob_decoder_edges(knob_decoder_t *dec, uint8_t level_a, uint8_t level_b, int falls, uint32_t now_us);
+
+    /**
+     * @brief Smoothed speed in detents per second, zero once the knob has been still for KNOB_DECODER_IDLE_US
+     */
+    uint32_t knob_decoder_velocity(const knob_decoder_t *dec, uint32_t now_us);
+
+    /**
+     * @brief Steps per detent the curve gives at a speed
+     */
+    int knob_decoder_accel_mult(const knob_accel_curve_t *curve, uint32_t dps);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,66 @@
+#ifndef KNOB_INPUT_H
+#define KNOB_INPUT_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include "encoder_manager.h"
+
+// Routes knob detents either to app switching or, as a native LVGL encoder
+// input device, to the active app's input group.
+//
+//   Navigate -> detents switch apps (AppManager)
+//   Focus    -> detents move focus / adjust the focused widget (LVGL group),
+//               or go raw to the app's onInput() if it has no group but usesKnob()
+//
+// Long-press on the screen background toggles the mode ("press to enter");
+// in Focus mode a short tap on the background is the encoder's key, which
+// clicks the focused widget or toggles editing of sliders, rollers, etc.
+// Switching apps always returns to Navigate.
+class KnobInput {
+public:
+    enum class Mode : uint8_t { Navigate, Focus };
+
+private:
+    static lv_indev_drv_t indevDrv;
+    static lv_indev_t* indev;
+    static portMUX_TYPE lock;
+
+    // Filled on the encoder task, consumed by the read callback on the UI task
+    static volatile Mode mode;
+    static volatile bool toApp;          // Focus mode without a group - InputFrame gets the knob
+    static int pendingDiff;
+    static uint8_t pendingPresses;
+    static bool keyDown;
+    static volatile bool readPending;
+
+    // App whose group the device is bound to
+    static lv_obj_t* boundScreen;
+    static lv_group_t* boundGroup;
+    static bool boundUsesKnob;
+
+    // Statistics
+    static uint32_t reads;
+    static uint32_t focusDetents;
+    static uint32_t presses;
+
+    static void onBatch(const EncoderBatch& batch, void* ctx);
+    static void readCb(lv_indev_drv_t* drv, lv_indev_data_t* data);
+    static void onScreenEvent(lv_event_t* e);
+    static void bindCurrentApp();
+
+public:
+    // Register the encoder input device and the knob listener (after LVGL and the encoder)
+    static bool begin();
+
+    // UI task, once per pass before lv_timer_handler(): follows app switches and
+    // feeds LVGL any buffered input - the device is never polled on a timer
+    static void service();
+
+    static bool setMode(Mode newMode);
+    static Mode getMode() { return mode; }
+    static void press();                 // Encoder key click, as a background tap in Focus mode
+
+    static void printStatus();
+};
+
+#endif // KNOB_INPUT_H
@@ -0,0 +1,44 @@
+#ifndef KNOB_TRACE_H
+#define KNOB_TRACE_H
+
+#include <Arduino.h>
+
+// Raw knob capture for reproducing missed or doubled detents off-device.
+// While running, every edge on either encoder line is timestamped with
+// both line levels into a PSRAM buffer; dump() prints it in the text
+// format read by tools/knob_replay.c. Capture runs alongside the normal
+// knob backend, so the device's own detent count is recorded for
+// comparison.
+class KnobTrace {
+private:
+    struct Sample {
+        uint32_t timeUs;   // Since start()
+        uint8_t a;
+        uint8_t b;
+    };
+
+    static const uint32_t CAPACITY = 32768;   // 256 KB of PSRAM
+
+    static Sample* samples;
+    static volatile uint32_t count;
+    static volatile uint32_t dropped;
+    static volatile bool running;
+    static uint32_t startUs;
+    static uint32_t durationUs;
+    static uint8_t startA, startB;
+    static int startSteps;
+    static int endSteps;
+
+    static void onEdge(void* arg);
+
+public:
+    static bool start();
+    static void stop();
+    static bool isRunning() { return running; }
+
+    // Text dump over serial - paste into a file for tools/knob_replay
+    static void dump();
+    static void printStatus();
+};
+
+#endif // KNOB_TRACE_H
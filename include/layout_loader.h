@@ -0,0 +1,103 @@
+#ifndef LAYOUT_LOADER_H
+#define LAYOUT_LOADER_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// Binary screen layouts compiled on the host by scripts/compile_layouts.py
+// from layouts/*.json and stored in SPIFFS as /layouts/<name>.bin.
+//
+// File format (little endian):
+//   LayoutHeader | LayoutNode[nodeCount] | string table (ends with a NUL)
+// Nodes are in pre-order, so every parent precedes its children and the
+// tree is instantiated in one pass straight from the records.
+
+#define LAYOUT_MAGIC    0x544C594B   // "KYLT"
+#define LAYOUT_VERSION  1
+
+enum LayoutNodeType : uint8_t {
+    LAYOUT_SCREEN = 0,               // Node 0 and only node 0
+    LAYOUT_OBJ,
+    LAYOUT_LABEL,
+    LAYOUT_SWITCH,
+    LAYOUT_BAR,
+    LAYOUT_ARC,
+};
+
+// Shared UiStyles, so a layout widget costs what its built-in twin does
+enum LayoutStyle : uint8_t {
+    LAYOUT_STYLE_NONE = 0,
+    LAYOUT_STYLE_TITLE,
+    LAYOUT_STYLE_BODY,
+    LAYOUT_STYLE_CAPTION,
+};
+
+#define LAYOUT_NO_TEXT       0xFFFF
+#define LAYOUT_COLOR_SET     0x01000000   // Colour fields are 0x01RRGGBB when present
+#define LAYOUT_SIZE_DEFAULT  0            // Keep the widget's own size
+#define LAYOUT_SIZE_CONTENT  -1           // LV_SIZE_CONTENT
+#define LAYOUT_SIZE_PCT_BASE -2           // -2 - p encodes lv_pct(p)
+
+struct LayoutHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t nodeCount;
+    uint16_t stringBytes;
+};
+
+struct LayoutNode {
+    uint8_t type;        // LayoutNodeType
+    uint8_t parent;      // Index of an earlier node
+    uint8_t align;       // lv_align_t
+    uint8_t font;        // 0 = default, otherwise Montserrat point size
+    int16_t x, y;        // Align offset
+    int16_t w, h;        // See LAYOUT_SIZE_*
+    uint32_t textColor;
+    uint32_t bgColor;
+    uint16_t text;       // Offset into the string table or LAYOUT_NO_TEXT
+    uint8_t id;          // 0 = anonymous, else slot in the caller's id table
+    uint8_t style;       // LayoutStyle
+};
+
+static_assert(sizeof(LayoutHeader) == 8, "LayoutHeader must match scripts/compile_layouts.py");
+static_assert(sizeof(LayoutNode) == 24, "LayoutNode must match scripts/compile_layouts.py");
+
+class LayoutLoader {
+private:
+    static const int MAX_LAYOUTS = 16;
+    static const int MAX_NODES = 64;
+
+    // Layout files stay cached for the life of the firmware - labels
+    // point straight into the string table
+    struct CachedLayout {
+        char name[16];
+        const uint8_t* data;
+        size_t size;
+        uint32_t readUs;
+    };
+
+    static CachedLayout cache[MAX_LAYOUTS];
+    static int cacheCount;
+    static bool mounted;
+    static bool enabled;
+
+    static const CachedLayout* find(const char* name);
+    static lv_coord_t sizeFor(int16_t value);
+
+public:
+    // Mount SPIFFS; without it every load() falls back to imperative code
+    static bool begin();
+
+    // Build a screen from /layouts/<name>.bin. Objects with an id are stored
+    // in ids[id] (ids must hold idCount entries). Returns nullptr if no
+    // valid layout is installed so the caller can build the screen itself.
+    static lv_obj_t* load(const char* name, lv_obj_t** ids = nullptr, int idCount = 0);
+
+    // Disable to force the imperative fallbacks (benchmarking)
+    static void setEnabled(bool on) { enabled = on; }
+    static bool isEnabled() { return enabled; }
+
+    static void printStatus();
+};
+
+#endif // LAYOUT_LOADER_H
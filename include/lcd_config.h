@@ -20,11 +20,17 @@
 // Touch pins (I2C)
 #define EXAMPLE_PIN_NUM_TOUCH_SCL 12
 #define EXAMPLE_PIN_NUM_TOUCH_SDA 11
+// CST816 INT line. Interrupt-driven touch needs it on a GPIO, and this pin map
+// has none for it, so the default -1 polls the controller over I2C on every
+// LVGL read. Boards that route INT set it here or with
+// -DEXAMPLE_PIN_NUM_TOUCH_INT=<gpio> in build_flags
+#ifndef EXAMPLE_PIN_NUM_TOUCH_INT
+#define EXAMPLE_PIN_NUM_TOUCH_INT -1
+#endif
 #define EXAMPLE_TOUCH_ADDR                0x15
 
 // LVGL Configuration
 #define EXAMPLE_LVGL_BUF_HEIGHT        (EXAMPLE_LCD_V_RES / 10)
-#define EXAMPLE_LVGL_TICK_PERIOD_MS    2                          
 #define EXAMPLE_LVGL_TASK_MAX_DELAY_MS 500                        
 #define EXAMPLE_LVGL_TASK_MIN_DELAY_MS 1                          
 #define EXAMPLE_LVGL_TASK_STACK_SIZE   (4 * 1024)                 
@@ -4,13 +4,31 @@
 #include <Arduino.h>
 #include <lvgl.h>
 #include "lcd_config.h"
+#include "esp_lcd_types.h"
+#include "esp_lcd_panel_io.h"
+#include "freertos/semphr.h"
 
 // Low-level LCD hardware driver
 class LcdDriver {
 private:
+    static esp_lcd_panel_handle_t panel;
+    static bool touchReady;
+    
+    // Finished colour transfers: an LVGL flush completes with lv_disp_flush_ready(),
+    // anything else (drawBitmap) is counted on transferDone
+    static lv_disp_drv_t* volatile flushingDrv;
+    static SemaphoreHandle_t transferDone;
+    static SemaphoreHandle_t flushDone;      // Given each time an LVGL flush completes
+    
+    // LVGL flush time, from display_flush_cb() to lv_disp_flush_ready()
+    static int64_t flushStartUs;
+    static uint32_t flushBusyUs;
+    static portMUX_TYPE flushStatsLock;
+    
     // Hardware-specific implementations
-    static void initHardware();
+    static bool initHardware();
     static void setupPins();
+    static bool onTransferDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t* edata, void* ctx);
     
 public:
     // Hardware initialization
@@ -20,12 +38,31 @@ public:
     // LVGL hardware callbacks
     static void display_flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
     static void touchpad_read_cb(lv_indev_drv_t *indev_driver, lv_indev_data_t *data);
+    static void rounder_cb(lv_disp_drv_t *disp, lv_area_t *area);  // SH8601 windows start and end on even pixels
+    static uint32_t takeFlushBusyUs();  // Flush time, DMA included, since the last call
+    static bool waitFlushDone(uint32_t timeoutMs);  // No LVGL flush left on the bus
     
     // Hardware control
     static void setBacklight(bool on);
     static void powerDown();
     static void powerUp();
     
+    // Panel access - attached by initLcd() once the SH8601 panel has been created
+    static void attachPanel(esp_lcd_panel_handle_t handle) { panel = handle; }
+    static bool hasPanel() { return panel != nullptr; }
+    
+    // Low-power panel modes (SH8601 partial and idle display)
+    static bool enterPartialMode(int yStart, int yEnd);
+    static bool exitPartialMode();
+    static bool setIdleMode(bool idle);
+    // Queues a DMA transfer: data must stay untouched until waitTransfer() says it has gone
+    static bool drawBitmap(int x1, int y1, int x2, int y2, const void* data);  // x2/y2 exclusive
+    static bool waitTransfer(uint32_t timeoutMs);                              // Oldest drawBitmap() done
+    
+    // Touch controller I2C statistics (polling vs interrupt mode)
+    static void printTouchStats();
+    static void resetTouchStats();
+    
     // Hardware info
     static int getScreenWidth() { return EXAMPLE_LCD_H_RES; }
     static int getScreenHeight() { return EXAMPLE_LCD_V_RES; }
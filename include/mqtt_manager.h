@@ -34,7 +34,40 @@ private:
     Preferences preferences;
     
     unsigned long lastReconnectAttempt = 0;
-    bool isConnected = false;
+    volatile bool isConnected = false;
+    volatile uint32_t inboundMessageCount = 0;
+    
+    // Background network task - once started it is the only task that touches
+    // mqttClient; other tasks hand it publishes through the outbox
+    struct OutboundMessage {
+        String topic;
+        String payload;
+        bool retained;
+    };
+    static const int OUTBOX_LENGTH = 8;
+    static const uint32_t OUTBOX_POLL_MS = 50;   // Only used if no eventfd could be created
+    TaskHandle_t loopTaskHandle = nullptr;
+    QueueHandle_t outbox = nullptr;
+    int wakeFd = -1;                             // eventfd the task selects on next to the socket
+    static void loopTask(void* arg);
+    bool ownsClient() const;
+    bool publishNow(const char* topic, const char* payload, bool retained);
+    void drainOutbox();
+    static const uint32_t KEEPALIVE_MARGIN_MS = 2000;  // Ping this long before keepAlive runs out
+    unsigned long lastOutMs = 0;                 // Last packet we wrote: connect, publish, (un)subscribe, ping
+    uint32_t keepAliveDeadlineMs() const;
+    bool sendPing();
+    uint32_t nextWaitMs();
+    void waitForWork(uint32_t timeoutMs);
+    
+    // Task statistics
+    volatile uint32_t socketWakeups = 0;
+    volatile uint32_t outboxWakeups = 0;
+    volatile uint32_t timeoutWakeups = 0;
+    volatile uint32_t publishesQueued = 0;
+    volatile uint32_t publishesDropped = 0;
+    volatile uint32_t pingsSent = 0;
+    unsigned long statsSince = 0;
     
     // Topic management
     std::vector<String> subscriptionTopics;
@@ -54,6 +87,9 @@ private:
     std::function<void(const JsonDocument&, const String&)> weatherCallback = nullptr;
     std::function<void(const JsonDocument&, const String&)> houseCallback = nullptr;
     
+    // Adds extra fields to the device status message
+    std::function<void(JsonDocument&)> statusCallback = nullptr;
+    
     // Internal methods
     void generateClientId();
     void cleanupWiFiManagerParameters();
@@ -73,14 +109,16 @@ public:
     void updateConfigFromWiFiManager(WiFiManagerCustom& wifiManager);
     bool setupWithWiFiManager(WiFiManagerCustom& wifiManager);
     
-    // Connection methods
+    // Connection methods - call from setup() or the MQTT task only
     bool begin();
     bool connect();
     void disconnect();
     bool reconnect();
     void loop();
+    bool startLoopTask();  // Run loop() on its own task, woken by socket data or a queued publish
     
-    // Publishing methods
+    // Publishing methods - safe from any task; off the MQTT task the message is
+    // queued and true means it was accepted, not yet sent
     bool publish(const char* topic, const char* payload, bool retained = false);
     bool publish(const char* topic, const String& payload, bool retained = false);
     bool publishJson(const char* topic, const JsonDocument& doc, bool retained = false);
@@ -110,12 +148,15 @@ public:
     void setEnergyCallback(std::function<void(const JsonDocument&, const String&)> callback);
     void setWeatherCallback(std::function<void(const JsonDocument&, const String&)> callback);
     void setHouseCallback(std::function<void(const JsonDocument&, const String&)> callback);
+    void setStatusCallback(std::function<void(JsonDocument&)> callback);
     
     // Status methods
     bool connected() const;
     String getClientId() const;
     String getServer() const;
     int getPort() const;
+    uint32_t getInboundMessageCount() const { return inboundMessageCount; }
+    void printStats();
     
     // Utility methods
     void resetConfig();
@@ -0,0 +1,46 @@
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// On-device performance overlay drawn on lv_layer_sys(). A single fixed-size
+// label is refreshed once per second and only when its text changes, so it
+// only ever invalidates its own small region.
+class PerfOverlay {
+private:
+    static const uint32_t UPDATE_PERIOD_MS = 1000;
+
+    static lv_obj_t* panel;
+    static lv_obj_t* label;
+    static lv_timer_t* timer;
+    static bool enabled;
+
+    // Previous samples for rate calculations
+    static int64_t lastSampleUs;
+    static uint32_t lastMqttCount;
+    static uint32_t lastIdleUs[portNUM_PROCESSORS];
+    static int64_t lastCpuSampleUs;
+
+    // Idle time per core, measured by FreeRTOS idle and tick hooks while enabled
+    static volatile uint32_t idleUs[portNUM_PROCESSORS];
+    static volatile int64_t waitStartUs[portNUM_PROCESSORS];
+    static volatile bool waitPreempted[portNUM_PROCESSORS];
+    static bool hooksInstalled;
+    static bool idleHook();
+    static void tickHook();
+    static void installHooks(bool on);
+
+    static void create();
+    static void update(lv_timer_t* t);
+    static void sampleCpuLoad(int loadPercent[portNUM_PROCESSORS]);
+
+public:
+    // Restore the saved state (call once LVGL is running)
+    static void begin();
+
+    static void setEnabled(bool on);
+    static bool isEnabled() { return enabled; }
+};
+
+#endif // PERF_OVERLAY_H
@@ -0,0 +1,69 @@
+#ifndef REDRAW_DEBUG_H
+#define REDRAW_DEBUG_H
+
+// Redraw-region debug mode - only compiled into debug builds
+// (build with -DDISPLAY_REDRAW_DEBUG, see the esp32-s3-devkitc-1-debug env)
+#ifdef DISPLAY_REDRAW_DEBUG
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// Tints and outlines every flushed area for a moment and logs the
+// invalidated pixel area against the active app - a summary line per
+// second, or every frame with "redraw log on"
+class RedrawDebug {
+private:
+    static const int MAX_TRACKED_AREAS = 16;     // Areas waiting to be restored
+    static const uint32_t HOLD_MS = 150;         // How long a tinted area stays visible
+    static const uint32_t RESTORE_PERIOD_MS = 50;
+    static const uint32_t SUMMARY_PERIOD_MS = 1000;
+    static const int MAX_APP_STATS = 8;
+
+    struct TrackedArea {
+        lv_area_t area;
+        uint32_t expiresMs;
+        bool active;
+    };
+
+    struct AppStats {
+        const char* name;
+        uint32_t frames;
+        uint64_t pixels;
+    };
+
+    static bool enabled;
+    static bool logFrames;
+    static bool restoring;
+    static lv_timer_t* restoreTimer;
+    static uint8_t tintIndex;
+    static uint32_t frameAreas;
+    static uint32_t framePixels;
+    static TrackedArea tracked[MAX_TRACKED_AREAS];
+    static AppStats appStats[MAX_APP_STATS];
+
+    // Summary since the last logged line
+    static uint32_t summaryStartMs;
+    static uint32_t summaryFrames;
+    static uint64_t summaryPixels;
+    static uint32_t summaryMaxMs;
+
+    static void trackArea(const lv_area_t* area);
+    static void restoreExpired(lv_timer_t* timer);
+    static void tintArea(const lv_area_t* area, lv_color_t* color_p);
+    static void recordFrame(uint32_t timeMs, uint32_t px);
+
+public:
+    // Control (serial console)
+    static void setEnabled(bool on);
+    static bool isEnabled() { return enabled; }
+    static void setFrameLogging(bool on);
+    static void printStats();
+
+    // LVGL display driver hooks - installed by DisplayManager
+    static void flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p);
+    static void monitor_cb(lv_disp_drv_t *disp, uint32_t time, uint32_t px);
+};
+
+#endif // DISPLAY_REDRAW_DEBUG
+
+#endif // REDRAW_DEBUG_H
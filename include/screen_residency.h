@@ -0,0 +1,67 @@
+/*
+ * Residency policy for app screens.
+ *
+ * Pure C with no LVGL or ESP-IDF dependencies so it can be compiled and
+ * exercised on the host. AppManager describes every app screen as a slot;
+ * the policy picks the least recently used screen that may go and keeps
+ * evicting through a callback until the resident count fits the budget or
+ * nothing more can be evicted.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief One app screen as the policy sees it
+     *
+     */
+    typedef struct
+    {
+        uint32_t last_used; /*!< LRU stamp, larger is more recent */
+        bool built;         /*!< Screen holds LVGL objects */
+        bool evictable;     /*!< Suspended, and not the screen LVGL is still showing */
+    } screen_slot_t;
+
+    /**
+     * @brief Release one screen
+     *
+     * @return true if the screen was released; false leaves it resident and
+     *         the policy will not ask for it again in the same trim
+     */
+    typedef bool (*screen_evict_fn)(int index, void *ctx);
+
+    /**
+     * @brief Number of built screens
+     */
+    int screen_residency_count(const screen_slot_t *slots, int count);
+
+    /**
+     * @brief Least recently used evictable screen
+     *
+     * @param keep, also_keep Never picked; -1 for none
+     *
+     * @return Slot index, or -1 if no screen may go
+     */
+    int screen_residency_pick(const screen_slot_t *slots, int count, int keep, int also_keep);
+
+    /**
+     * @brief Evict least recently used screens until at most limit are built
+     *
+     * Always terminates: every slot is offered at most once, and slots the
+     * callback refuses are marked not evictable.
+     *
+     * @return true if the resident count is now within limit
+     */
+    bool screen_residency_trim(screen_slot_t *slots, int count, int limit, int keep, int also_keep,
+                               screen_evict_fn evict, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
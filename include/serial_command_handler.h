@@ -12,17 +12,29 @@ private:
     static bool enabled;
     static unsigned long lastCommandTime;
     static const unsigned long COMMAND_TIMEOUT_MS = 30000; // 30 seconds timeout
+    static const int SOAK_HEAP_TOLERANCE = 1024;           // Bytes of heap drift allowed by 'apps soak'
     
     // Command processing methods
     static void processWiFiCommands(const String& command);
     static void processMQTTCommands(const String& command);
     static void processSystemCommands(const String& command);
     static void processInfoCommands(const String& command);
+    static void processDisplayCommands(const String& command);
+    static void processAppCommands(const String& command);
+    static void processLayoutCommands(const String& command);
+    static void processAppMemoryCommands(const String& command);
+    static void processPoolCommands(const String& command);
+    static void processKnobCommands(const String& command);
+#ifdef DISPLAY_REDRAW_DEBUG
+    static void processRedrawCommands(const String& command);
+#endif
     
     // Utility methods
     static void printHelp();
     static void printDeviceStatus();
     static void printSystemInfo();
+    static void runAppSoak(int cycles);
+    static void runLayoutBench(int iterations);
     
 public:
     // Initialization and control
@@ -4,6 +4,11 @@
 #include "base_app.h"
 
 class SettingsApp : public BaseApp {
+private:
+    lv_obj_t* perfSwitch = nullptr;
+    
+    static void onPerfSwitchChanged(lv_event_t* e);
+    
 public:
     bool init() override;
     void deinit() override;
@@ -0,0 +1,30 @@
+/*
+ * SH8601 AMOLED bring-up over QSPI, shared by the display drivers.
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Initialize the QSPI bus and the panel, reset it and run the init sequence
+     *
+     * @param on_trans_done Called from the SPI interrupt when a colour transfer has left its buffer
+     * @param ctx Passed to on_trans_done
+     * @param[out] ret_panel Panel handle for esp_lcd_panel_draw_bitmap() and the esp_lcd_sh8601_* calls
+     *
+     * @return ESP_OK, or the first error; nothing is left half-initialized on the panel handle
+     */
+    esp_err_t sh8601_panel_create(esp_lcd_panel_io_color_trans_done_cb_t on_trans_done, void *ctx,
+                                  esp_lcd_panel_handle_t *ret_panel);
+
+#ifdef __cplusplus
+}
+#endif
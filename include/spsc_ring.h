@@ -0,0 +1,70 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free single-producer / single-consumer ring. Exactly one task may
+// push and exactly one (other) task may pop; neither ever blocks or takes
+// a lock. When full, push() drops the new item and counts it.
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+private:
+    T items[N];
+    std::atomic<uint32_t> head{0};   // Next slot to write - producer only
+    std::atomic<uint32_t> tail{0};   // Next slot to read - consumer only
+
+    // Producer-side statistics
+    uint32_t pushed = 0;
+    uint32_t dropped = 0;
+    uint32_t overflows = 0;          // Times the ring became full
+    uint32_t highWater = 0;
+    bool wasFull = false;
+
+public:
+    // Producer only
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t used = h - tail.load(std::memory_order_acquire);
+        if (used >= N) {
+            dropped++;
+            if (!wasFull) overflows++;
+            wasFull = true;
+            return false;
+        }
+        wasFull = false;
+
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+
+        pushed++;
+        if (used + 1 > highWater) highWater = used + 1;
+        return true;
+    }
+
+    // Consumer only
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+
+        item = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called from a third task
+    uint32_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    static constexpr uint32_t capacity() { return N; }
+
+    uint32_t getPushed() const { return pushed; }
+    uint32_t getDropped() const { return dropped; }
+    uint32_t getOverflows() const { return overflows; }
+    uint32_t getHighWater() const { return highWater; }
+    void resetStats() { pushed = dropped = overflows = highWater = 0; }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,148 @@
+/*
+ * Touch gesture recognizer for the round panel.
+ *
+ * Pure C with no ESP-IDF dependencies so it can be compiled and exercised
+ * on the host. The touch driver feeds it every sample it reads; it reports
+ * taps, double taps, long presses, swipes and rotation around the center
+ * of the screen. All math is integer: distances are compared squared and
+ * angles are binary angles, 65536 to a turn, so differences wrap by
+ * themselves.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** Degrees to a binary angle */
+#define TOUCH_GESTURE_ANGLE(deg) ((uint16_t)((deg) * 65536L / 360))
+
+    /**
+     * @brief Gesture kinds
+     *
+     */
+    typedef enum
+    {
+        TOUCH_GESTURE_NONE = 0,
+        TOUCH_GESTURE_TAP,        /*!< Short press without movement, reported for every tap */
+        TOUCH_GESTURE_DOUBLE_TAP, /*!< Second tap close in time and place to the one before */
+        TOUCH_GESTURE_LONG_PRESS, /*!< Held still past long_press_us, reported while still down */
+        TOUCH_GESTURE_SWIPE,      /*!< Quick straight drag, reported on release */
+        TOUCH_GESTURE_ROTATE,     /*!< Drag around the bezel, reported as it moves */
+    } touch_gesture_type_t;
+
+    /**
+     * @brief Swipe directions, by the dominant axis
+     *
+     */
+    typedef enum
+    {
+        TOUCH_SWIPE_NONE = 0,
+        TOUCH_SWIPE_LEFT,
+        TOUCH_SWIPE_RIGHT,
+        TOUCH_SWIPE_UP,
+        TOUCH_SWIPE_DOWN,
+    } touch_swipe_dir_t;
+
+    /**
+     * @brief One recognised gesture
+     *
+     */
+    typedef struct
+    {
+        touch_gesture_type_t type;
+        touch_swipe_dir_t swipe; /*!< TOUCH_GESTURE_SWIPE only */
+        int16_t angle;           /*!< TOUCH_GESTURE_ROTATE: angle since the last event, clockwise positive */
+        int8_t steps;            /*!< TOUCH_GESTURE_ROTATE: whole rotate_step units completed, signed */
+        int16_t x;               /*!< Where the gesture started */
+        int16_t y;
+    } touch_gesture_event_t;
+
+    /**
+     * @brief Thresholds, in pixels, microseconds and binary angles
+     *
+     */
+    typedef struct
+    {
+        int16_t center_x;
+        int16_t center_y;
+        uint16_t ring_inner;      /*!< Rotation only starts and continues this far from the center */
+        uint16_t slop;            /*!< Movement below this is still a press */
+        uint16_t swipe_min;       /*!< Shortest swipe */
+        uint32_t swipe_max_us;    /*!< Slowest swipe, touch down to release */
+        uint32_t long_press_us;
+        uint32_t double_tap_us;   /*!< Second tap must go down this soon after the first one lifts */
+        uint16_t double_tap_slop; /*!< ... and this close to it */
+        uint16_t rotate_start;    /*!< Angle swept before a bezel drag becomes a rotation */
+        uint16_t rotate_step;     /*!< Angle per rotation step */
+    } touch_gesture_config_t;
+
+/** 360x360 panel: bezel ring from 110 px out, 24 rotation steps per turn */
+#define TOUCH_GESTURE_CONFIG_DEFAULT \
+    {180, 180, 110, 12, 60, 500000, 500000, 300000, 40, TOUCH_GESTURE_ANGLE(15), TOUCH_GESTURE_ANGLE(15)}
+
+/** Most events a single sample can produce */
+#define TOUCH_GESTURE_MAX_EVENTS 2
+
+    /**
+     * @brief Recognizer state for one touch surface
+     *
+     */
+    typedef struct
+    {
+        touch_gesture_config_t cfg;
+
+        bool down;
+        bool moved;            /*!< Left the slop circle since touch down */
+        bool long_fired;
+        bool in_ring;          /*!< Still a rotation candidate */
+        bool rotating;
+        int16_t start_x, start_y;
+        int16_t last_x, last_y;
+        uint32_t down_us;
+        uint16_t last_angle;   /*!< Binary angle of the last sample around the center */
+        int32_t swept;         /*!< Net angle since touch down */
+        int32_t step_residue;  /*!< Rotation not yet reported as whole steps */
+
+        bool tap_pending;      /*!< A tap that a second one could make double */
+        uint32_t tap_up_us;
+        int16_t tap_x, tap_y;
+
+        uint32_t samples;
+        uint32_t events;
+    } touch_gesture_t;
+
+    /**
+     * @brief Reset a recognizer; a NULL config takes TOUCH_GESTURE_CONFIG_DEFAULT
+     */
+    void touch_gesture_init(touch_gesture_t *g, const touch_gesture_config_t *cfg);
+
+    /**
+     * @brief Feed one touch sample
+     *
+     * Samples need not be evenly spaced, but a long press is only noticed
+     * on a sample, so keep them coming while the finger is down.
+     *
+     * @param pressed Finger down; x and y are ignored when it is not
+     * @param out Room for TOUCH_GESTURE_MAX_EVENTS events
+     *
+     * @return Number of events written to out
+     */
+    int touch_gesture_feed(touch_gesture_t *g, bool pressed, int16_t x, int16_t y, uint32_t now_us,
+                           touch_gesture_event_t *out);
+
+    /**
+     * @brief Binary angle of a point around the origin, clockwise from +x with y pointing down
+     *
+     * Integer approximation, within 0.3 degrees.
+     */
+    uint16_t touch_gesture_angle(int32_t x, int32_t y);
+
+#ifdef __cplusplus
+}
+#endif
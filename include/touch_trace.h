@@ -0,0 +1,56 @@
+#ifndef TOUCH_TRACE_H
+#define TOUCH_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C entry point for the touch driver - every sample it hands the gesture recognizer
+void touch_trace_record(bool pressed, int16_t x, int16_t y);
+
+#ifdef __cplusplus
+}
+
+#include <Arduino.h>
+
+// Touch capture for tuning and checking gestures off-device. While
+// running, every sample the gesture recognizer sees is timestamped into a
+// PSRAM buffer (runs of released samples are kept once); dump() prints it
+// in the text format read by tools/touch_replay.c.
+class TouchTrace {
+private:
+    struct Sample {
+        uint32_t timeUs;   // Since start()
+        int16_t x;         // Screen coordinates, as fed to the recognizer
+        int16_t y;
+        uint8_t pressed;
+    };
+
+    static const uint32_t CAPACITY = 16384;   // 192 KB of PSRAM, ~160 s of touching
+
+    static Sample* samples;
+    static volatile uint32_t count;
+    static volatile uint32_t dropped;
+    static volatile bool running;
+    static bool lastPressed;
+    static uint32_t startUs;
+    static uint32_t durationUs;
+
+public:
+    static void record(bool pressed, int16_t x, int16_t y);
+
+    static bool start();
+    static void stop();
+    static bool isRunning() { return running; }
+
+    // Text dump over serial - paste into a file for tools/touch_replay
+    static void dump();
+    static void printStatus();
+};
+
+#endif // __cplusplus
+
+#endif // TOUCH_TRACE_H
@@ -0,0 +1,67 @@
+#ifndef UI_SCHEDULER_H
+#define UI_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Notification sources that wake the UI loop
+#define UI_EVENT_INPUT       (1u << 0)   // Encoder / touch input arrived
+#define UI_EVENT_MQTT        (1u << 1)   // MQTT inbound message handled
+#define UI_EVENT_FLUSH_DONE  (1u << 2)   // Panel finished a colour transfer
+#define UI_EVENT_REQUEST     (1u << 3)   // Anything else asking for a UI pass
+#define UI_EVENT_SERIAL      (1u << 4)   // Serial command bytes arrived
+#define UI_EVENT_COUNT       5
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// C entry points for drivers - safe to call before the scheduler is started
+void ui_scheduler_notify(uint32_t events);
+bool ui_scheduler_notify_from_isr(uint32_t events);  // true if a higher priority task was woken
+
+#ifdef __cplusplus
+}
+
+#include <Arduino.h>
+
+// Event-driven UI loop: runs LVGL and the active app, then blocks on a single
+// task notification until input, MQTT data, a flush or serial input wakes it,
+// or until the next LVGL timer is due
+class UiScheduler {
+private:
+    static TaskHandle_t uiTask;
+
+    // Statistics
+    static uint32_t wakeups;
+    static uint32_t timeoutWakeups;
+    static uint32_t lvglDeadlines;      // Timeouts set by the next LVGL timer
+    static uint32_t appDeadlines;       // ... by the active app
+    static uint32_t idleDeadlines;      // ... by EXAMPLE_LVGL_TASK_MAX_DELAY_MS
+    static uint64_t sleptUs;
+    static uint32_t eventWakeups[UI_EVENT_COUNT];
+    static volatile int64_t inputPendingSince;
+    static uint32_t inputLatencySamples;
+    static uint64_t inputLatencyTotalUs;
+    static uint32_t inputLatencyMaxUs;
+    static unsigned long statsSince;
+
+public:
+    // Bind the scheduler to the calling task (the Arduino loop task)
+    static void begin();
+
+    // One scheduler pass - call repeatedly from loop()
+    static void runOnce();
+
+    // Wake the UI loop
+    static void notify(uint32_t events);
+    static bool notifyFromISR(uint32_t events);
+
+    // Status
+    static void printStats();
+    static void resetStats();
+};
+
+#endif // __cplusplus
+
+#endif // UI_SCHEDULER_H
@@ -0,0 +1,28 @@
+#ifndef UI_STYLES_H
+#define UI_STYLES_H
+
+#include <lvgl.h>
+
+// Framework-wide styles, initialised once and shared by every app. Adding
+// one of these to an object stores a pointer only - unlike local style
+// setters, nothing is allocated per object.
+class UiStyles {
+private:
+    static bool initialized;
+    static lv_style_t titleStyle;
+    static lv_style_t bodyStyle;
+    static lv_style_t captionStyle;
+    static lv_style_t fontStyles[5];   // Montserrat 12/14/16/18/20
+
+public:
+    static void begin();
+
+    static lv_style_t* title() { return &titleStyle; }
+    static lv_style_t* body() { return &bodyStyle; }
+    static lv_style_t* caption() { return &captionStyle; }
+
+    // Font-only style for a Montserrat point size, nullptr if not enabled
+    static lv_style_t* font(uint8_t size);
+};
+
+#endif // UI_STYLES_H
@@ -0,0 +1,77 @@
+#ifndef UI_UPDATE_QUEUE_H
+#define UI_UPDATE_QUEUE_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// Widget property an update targets - one pending value is kept per (widget, property)
+enum class UiProp : uint8_t { Text, Value, Hidden, TextColor };
+
+// Stable reference to a bound widget: (generation << 8) | binding slot.
+// Other tasks post through handles, never raw lv_obj_t pointers - once the
+// widget is unbound its slot's generation moves on, so an update posted
+// through the old handle is dropped even if LVGL (or WidgetPool) has since
+// handed the same memory to another object.
+typedef uint32_t UiHandle;
+#define UI_HANDLE_NONE 0
+
+// Lets any task (not ISRs) post widget updates without touching LVGL. The
+// UI task drains the queue once per pass, before rendering; repeated posts
+// to the same widget property overwrite each other, so a burst of sensor
+// updates costs one LVGL call and one redraw.
+class UiUpdateQueue {
+private:
+    static const int CAPACITY = 48;
+    static const int TEXT_MAX = 32;
+    static const int MAX_BINDINGS = 32;
+
+    struct Entry {
+        UiHandle target;       // UI_HANDLE_NONE = free slot
+        UiProp prop;
+        int32_t value;
+        char text[TEXT_MAX];
+    };
+
+    // Written and read on the UI task only
+    struct Binding {
+        lv_obj_t* obj;         // nullptr = free
+        uint32_t generation;   // 24 bits, never 0
+    };
+
+    static Entry entries[CAPACITY];
+    static int pending;
+    static portMUX_TYPE lock;
+    static Binding bindings[MAX_BINDINGS];
+
+    // Statistics
+    static uint32_t posted;
+    static uint32_t coalesced;
+    static uint32_t applied;
+    static uint32_t dropped;
+    static uint32_t stale;
+    static uint32_t drains;
+
+    static bool post(UiHandle target, UiProp prop, int32_t value, const char* text);
+    static lv_obj_t* resolve(UiHandle target);
+    static void discard(UiHandle target);
+    static void apply(lv_obj_t* obj, const Entry& entry);
+
+public:
+    // Any task
+    static bool setText(UiHandle target, const char* text);
+    static bool setTextf(UiHandle target, const char* format, ...);
+    static bool setValue(UiHandle target, int32_t value);     // Bar, arc or slider
+    static bool setHidden(UiHandle target, bool hidden);
+    static bool setTextColor(UiHandle target, uint32_t rgb);
+
+    // UI task only
+    static UiHandle bind(lv_obj_t* obj);   // UI_HANDLE_NONE if every slot is taken
+    static void unbind(UiHandle target);   // Before the widget is deleted or reclaimed
+    static void drain();
+    static void purge(lv_obj_t* root);     // Unbind root and its children before deleting it
+
+    static void printStats();
+    static void resetStats();
+};
+
+#endif // UI_UPDATE_QUEUE_H
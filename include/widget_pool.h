@@ -0,0 +1,69 @@
+#ifndef WIDGET_POOL_H
+#define WIDGET_POOL_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+enum class PooledWidget : uint8_t { Label, Arc, Bar, Count };
+
+// Recyclable widgets shared by all apps. Screens borrow labels, arcs and
+// bars instead of creating them, and reclaim() hands them back before the
+// screen is deleted, so rebuilding an evicted screen reuses the same LVGL
+// blocks. A returned widget is put back the way its constructor left it:
+// theme styles, flags, range, angles and modes, with event callbacks,
+// user data and group membership removed.
+class WidgetPool {
+private:
+    static const int CAPACITY = 16;   // Free widgets kept per type
+
+    struct Pool {
+        lv_obj_t* free[CAPACITY];
+        int count;
+        lv_coord_t defaultWidth;
+        lv_coord_t defaultHeight;
+        lv_obj_flag_t defaultFlags;   // Flags after create(), restored on return
+        bool defaultsKnown;
+        size_t objectBytes;           // LVGL bytes one widget took when first created
+        uint32_t hits;
+        uint32_t misses;
+        uint32_t returns;
+        uint32_t discards;
+    };
+
+    static Pool pools[(int)PooledWidget::Count];
+    static lv_obj_t* parking;         // Never-loaded screen that owns free widgets
+    static bool enabled;
+    static size_t lentBytes;
+
+    static lv_obj_t* create(PooledWidget type, lv_obj_t* parent);
+    static void giveBack(PooledWidget type, lv_obj_t* obj);
+    static bool typeOf(lv_obj_t* obj, PooledWidget& type);
+    static void reclaimChildren(lv_obj_t* root);
+
+public:
+    // Create the parking screen and pre-warm each pool
+    static void begin(int labels = 8, int arcs = 2, int bars = 2);
+
+    static lv_obj_t* borrow(PooledWidget type, lv_obj_t* parent);
+    static lv_obj_t* label(lv_obj_t* parent) { return borrow(PooledWidget::Label, parent); }
+    static lv_obj_t* arc(lv_obj_t* parent) { return borrow(PooledWidget::Arc, parent); }
+    static lv_obj_t* bar(lv_obj_t* parent) { return borrow(PooledWidget::Bar, parent); }
+
+    // Return every borrowed widget under root - call before deleting root.
+    // Also unbinds their UiUpdateQueue handles.
+    static void reclaim(lv_obj_t* root);
+
+    // LVGL bytes of every widget handed out from a free list so far. Those
+    // blocks were allocated before the borrower ran, so a lv_mem_monitor()
+    // delta around a screen build misses them - AppManager adds the growth.
+    static size_t lentBytesTotal() { return lentBytes; }
+
+    // Disabled, borrow() creates and reclaim() deletes (for comparison)
+    static void setEnabled(bool on) { enabled = on; }
+    static bool isEnabled() { return enabled; }
+
+    static void printStats();
+    static void resetStats();
+};
+
+#endif // WIDGET_POOL_H
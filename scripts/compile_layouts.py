@@ -0,0 +1,174 @@
+"""Compile declarative screen layouts into the binary format read by LayoutLoader.
+
+    layouts/<name>.json  ->  data/layouts/<name>.bin
+
+Runs automatically as a PlatformIO pre-build script; upload the result with
+`pio run -t uploadfs`. Can also be run by hand:
+
+    python scripts/compile_layouts.py [project_dir]
+
+The record layout must match include/layout_loader.h.
+"""
+
+import json
+import os
+import struct
+import sys
+
+MAGIC = 0x544C594B  # "KYLT"
+VERSION = 1
+MAX_NODES = 64
+
+HEADER = struct.Struct("<IBBH")
+NODE = struct.Struct("<BBBBhhhhIIHBB")
+
+TYPES = {"screen": 0, "obj": 1, "label": 2, "switch": 3, "bar": 4, "arc": 5}
+
+# lv_align_t (LVGL 8.3)
+ALIGNS = {
+    "default": 0, "top_left": 1, "top_mid": 2, "top_right": 3,
+    "bottom_left": 4, "bottom_mid": 5, "bottom_right": 6,
+    "left_mid": 7, "right_mid": 8, "center": 9,
+}
+
+FONTS = (0, 12, 14, 16, 18, 20)  # Montserrat sizes enabled in lv_conf.h
+
+# LayoutStyle - shared UiStyles
+STYLES = {None: 0, "title": 1, "body": 2, "caption": 3}
+
+NO_TEXT = 0xFFFF
+COLOR_SET = 0x01000000
+SIZE_DEFAULT = 0
+SIZE_CONTENT = -1
+SIZE_PCT_BASE = -2
+
+
+class LayoutError(Exception):
+    pass
+
+
+def parse_color(value, where):
+    if value is None:
+        return 0
+    if not (isinstance(value, str) and value.startswith("#") and len(value) == 7):
+        raise LayoutError(f"{where}: colour must be '#RRGGBB', got {value!r}")
+    return COLOR_SET | int(value[1:], 16)
+
+
+def parse_size(value, where):
+    if value is None:
+        return SIZE_DEFAULT
+    if value == "content":
+        return SIZE_CONTENT
+    if isinstance(value, str) and value.endswith("%"):
+        pct = int(value[:-1])
+        if not 0 <= pct <= 100:
+            raise LayoutError(f"{where}: percentage out of range: {value}")
+        return SIZE_PCT_BASE - pct
+    if isinstance(value, int) and 0 < value < 32768:
+        return value
+    raise LayoutError(f"{where}: size must be pixels, 'N%' or 'content', got {value!r}")
+
+
+def compile_layout(doc, name):
+    nodes = []
+    strings = bytearray()
+    string_offsets = {}
+
+    def intern(text):
+        if text not in string_offsets:
+            string_offsets[text] = len(strings)
+            strings.extend(text.encode("utf-8") + b"\0")
+        return string_offsets[text]
+
+    def emit(node, parent, where):
+        kind = node.get("type", "obj") if parent is not None else "screen"
+        if kind not in TYPES:
+            raise LayoutError(f"{where}: unknown type {kind!r}")
+        if parent is not None and kind == "screen":
+            raise LayoutError(f"{where}: only the root can be a screen")
+        align = node.get("align", "center" if parent is not None else "default")
+        if align not in ALIGNS:
+            raise LayoutError(f"{where}: unknown align {align!r}")
+        font = node.get("font", 0)
+        if font not in FONTS:
+            raise LayoutError(f"{where}: font {font} is not enabled (use one of {FONTS[1:]})")
+        style = node.get("style")
+        if style not in STYLES:
+            raise LayoutError(f"{where}: unknown style {style!r}")
+        node_id = node.get("id", 0)
+        if not 0 <= node_id <= 255:
+            raise LayoutError(f"{where}: id must be 0..255")
+        text = node.get("text")
+
+        if len(nodes) >= MAX_NODES:
+            raise LayoutError(f"{name}: more than {MAX_NODES} nodes")
+        index = len(nodes)
+        nodes.append((
+            TYPES[kind],
+            0 if parent is None else parent,
+            ALIGNS[align],
+            font,
+            node.get("x", 0),
+            node.get("y", 0),
+            parse_size(node.get("w"), where),
+            parse_size(node.get("h"), where),
+            parse_color(node.get("color"), where),
+            parse_color(node.get("bg"), where),
+            NO_TEXT if text is None else intern(text),
+            node_id,
+            STYLES[style],
+        ))
+
+        # Pre-order: parents always precede their children
+        for i, child in enumerate(node.get("children", [])):
+            emit(child, index, f"{where}.children[{i}]")
+
+    emit(doc, None, name)
+
+    if len(strings) >= NO_TEXT:
+        raise LayoutError(f"{name}: string table too large")
+
+    out = bytearray(HEADER.pack(MAGIC, VERSION, len(nodes), len(strings)))
+    for record in nodes:
+        out += NODE.pack(*record)
+    out += strings
+    return bytes(out)
+
+
+def compile_all(project_dir):
+    source_dir = os.path.join(project_dir, "layouts")
+    output_dir = os.path.join(project_dir, "data", "layouts")
+    if not os.path.isdir(source_dir):
+        return 0
+
+    os.makedirs(output_dir, exist_ok=True)
+    count = 0
+    for filename in sorted(os.listdir(source_dir)):
+        if not filename.endswith(".json"):
+            continue
+        name = filename[:-5]
+        with open(os.path.join(source_dir, filename), encoding="utf-8") as f:
+            blob = compile_layout(json.load(f), name)
+
+        target = os.path.join(output_dir, name + ".bin")
+        if not os.path.exists(target) or open(target, "rb").read() != blob:
+            with open(target, "wb") as f:
+                f.write(blob)
+        print(f"Layout {name}: {len(blob)} bytes")
+        count += 1
+    return count
+
+
+try:
+    Import("env")  # noqa: F821 - provided when run by PlatformIO
+except NameError:
+    env = None
+
+if env is not None:
+    compile_all(env.subst("$PROJECT_DIR"))
+elif __name__ == "__main__":
+    try:
+        compile_all(sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(__file__), ".."))
+    except LayoutError as e:
+        sys.exit(f"error: {e}")
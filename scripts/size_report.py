@@ -0,0 +1,100 @@
+"""Report where the firmware's flash and RAM go, with the app registry split out.
+
+Adds a custom PlatformIO target (post script):
+
+    pio run -t sizes
+
+It prints the ELF's memory sections, then the symbols of the app layer:
+AppRegistry's static tuple and tables, each app's vtable and each app's
+member functions, with totals for flash and RAM. Run it before and after a
+change to the app list or BaseApp to see what the change cost.
+"""
+
+import os
+import re
+import subprocess
+
+SECTIONS = (".iram0.text", ".iram0.vectors", ".dram0.data", ".dram0.bss",
+            ".flash.text", ".flash.rodata", ".flash.appdesc")
+
+# Sections loaded into internal RAM; everything else in the list lives in flash
+RAM_SECTIONS = re.compile(r"^\.(iram|dram|data|bss)")
+
+APP_SYMBOL = re.compile(r"AppRegistry|\b\w+App::|vtable for \w+App\b|typeinfo for \w+App\b")
+
+
+def run(cmd):
+    return subprocess.run(cmd, capture_output=True, text=True, check=True).stdout
+
+
+def read_sections(size_tool, elf):
+    """(name, size, address) for every allocated section"""
+    sections = []
+    for line in run([size_tool, "-A", elf]).splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[0].startswith(".") and fields[2].isdigit() and int(fields[2]):
+            sections.append((fields[0], int(fields[1]), int(fields[2])))
+    return sections
+
+
+def section_sizes(sections, elf):
+    print("Sections (%s):" % os.path.basename(elf))
+    for name, size, _ in sections:
+        if name in SECTIONS:
+            print("  %-16s %8d bytes" % (name, size))
+
+
+def in_ram(sections, address):
+    """True/False for a symbol in internal RAM/flash, None if outside every section"""
+    for name, size, start in sections:
+        if start <= address < start + size:
+            return bool(RAM_SECTIONS.match(name))
+    return None
+
+
+def app_symbols(nm_tool, elf, sections):
+    flash = ram = 0
+    rows = []
+    for line in run([nm_tool, "-C", "-S", "--size-sort", elf]).splitlines():
+        # address size type name
+        parts = line.split(None, 3)
+        if len(parts) < 4 or not APP_SYMBOL.search(parts[3]):
+            continue
+        address, size, name = int(parts[0], 16), int(parts[1], 16), parts[3]
+        ram_symbol = in_ram(sections, address)
+        if ram_symbol is None:
+            continue
+        if ram_symbol:
+            ram += size
+        else:
+            flash += size
+        rows.append((size, ram_symbol, name))
+
+    print("App layer symbols:")
+    for size, ram_symbol, name in sorted(rows, reverse=True):
+        print("  %6d %s %s" % (size, "ram  " if ram_symbol else "flash", name))
+    print("App layer total: %d bytes flash, %d bytes RAM" % (flash, ram))
+
+
+def report(target, source, env):
+    elf = env.subst("$BUILD_DIR/${PROGNAME}.elf")
+    size_tool = env.subst("$SIZETOOL")
+    nm_tool = re.sub(r"(gcc|g\+\+)$", "nm", env.subst("$CC"))
+    sections = read_sections(size_tool, elf)
+    section_sizes(sections, elf)
+    app_symbols(nm_tool, elf, sections)
+
+
+try:
+    Import("env")  # noqa: F821 - provided when run by PlatformIO
+except NameError:
+    env = None
+
+if env is not None:
+    env.AddCustomTarget(
+        name="sizes",
+        dependencies="$BUILD_DIR/${PROGNAME}.elf",
+        actions=[report],
+        title="Sizes",
+        description="Flash and RAM by section and for the app layer",
+    )
@@ -1,27 +1,103 @@
 #include "clock_app.h"
-#include "app_manager.h"
+#include "layout_loader.h"
+#include "widget_pool.h"
+#include "ui_styles.h"
+#include "esp_timer.h"
 
 bool ClockApp::init() {
     if (initialized) return true;
-    appManager.registerApp(this);
     screen = createScreen();
+    timerLabel = (lv_obj_t*)lv_obj_get_user_data(screen);
+    render();
     initialized = true;
     return true;
 }
 
 void ClockApp::deinit() {
-    if (screen) { lv_obj_del(screen); screen = nullptr; }
+    if (screen) {
+        WidgetPool::reclaim(screen);  // Borrowed widgets go back before the screen is deleted
+        lv_obj_del(screen);
+        screen = nullptr;
+    }
+    timerLabel = nullptr;
     initialized = false;
 }
 
 lv_obj_t* ClockApp::createScreen() {
-    lv_obj_t* scr = lv_obj_create(NULL);
-    lv_obj_t* title = lv_label_create(scr);
-    lv_label_set_text(title, "Clock");
-    lv_obj_align(title, LV_ALIGN_CENTER, 0, 0);
+    // Layout ids: 1 = timer label
+    lv_obj_t* ids[2];
+    lv_obj_t* scr = LayoutLoader::load("clock", ids, 2);
+    lv_obj_t* value = scr ? ids[1] : nullptr;
+    if (scr && !value) {
+        WidgetPool::reclaim(scr);  // Installed layout is missing the timer label
+        lv_obj_del(scr);
+        scr = nullptr;
+    }
+    
+    if (!scr) {
+        // Built-in screen when no layout is installed
+        scr = lv_obj_create(NULL);
+        lv_obj_t* title = WidgetPool::label(scr);
+        lv_obj_add_style(title, UiStyles::title(), 0);
+        lv_label_set_text_static(title, "Clock");
+        lv_obj_align(title, LV_ALIGN_CENTER, 0, -30);
+        
+        value = WidgetPool::label(scr);
+        lv_obj_add_style(value, UiStyles::body(), 0);
+        lv_obj_align(value, LV_ALIGN_CENTER, 0, 20);
+    }
+    
+    // Keep createScreen() free of side effects - init() picks the label up from here
+    lv_obj_set_user_data(scr, value);
     return scr;
 }
 
 void ClockApp::onEnter() { if (screen) lv_scr_load(screen); }
 void ClockApp::onExit() {}
-void ClockApp::update() {}
+
+int ClockApp::remainingS() const {
+    if (!running) return timerS;
+    int64_t left = endUs - esp_timer_get_time();
+    return left > 0 ? (int)((left + 999999) / 1000000) : 0;
+}
+
+void ClockApp::render() {
+    if (!timerLabel) return;
+    int s = remainingS();
+    lv_label_set_text_fmt(timerLabel, running ? "%d:%02d left" : "Timer %d:%02d", s / 60, s % 60);
+}
+
+// Once a second while the countdown runs (getSchedule), never otherwise
+void ClockApp::update() {
+    if (!running) return;
+    if (remainingS() == 0) {
+        running = false;
+        timerS = 0;
+    }
+    render();
+}
+
+// However many detents arrived this frame, one model change and one label update
+void ClockApp::onInput(const InputSnapshot& input) {
+    if (!input.hasKnob()) return;
+
+    if (input.knobSteps) {
+        int s = remainingS() + input.knobSteps * 60;
+        s = s < 0 ? 0 : (s > MAX_TIMER_S ? MAX_TIMER_S : s);
+        if (running) endUs = esp_timer_get_time() + (int64_t)s * 1000000;
+        timerS = s;
+        if (s == 0) running = false;
+    }
+
+    // Each key press starts or stops the countdown
+    for (uint8_t i = 0; i < input.keyPresses; i++) {
+        if (running) {
+            timerS = remainingS();
+            running = false;
+        } else if (timerS > 0) {
+            endUs = esp_timer_get_time() + (int64_t)timerS * 1000000;
+            running = true;
+        }
+    }
+    render();
+}
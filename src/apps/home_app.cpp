@@ -1,30 +1,38 @@
 #include "home_app.h"
-#include "app_manager.h"
+#include "layout_loader.h"
+#include "widget_pool.h"
+#include "ui_styles.h"
 
 HomeApp::HomeApp() {
-    // Constructor - does nothing now since we register during init()
+    // Constructor - registration happens in setup(), the screen is built on first visit
 }
 
 bool HomeApp::init() {
     if (initialized) return true;
-    
-    // Register this app with the AppManager
-    appManager.registerApp(this);
-    
+
     screen = createScreen();
     initialized = true;
     return true;
 }
 
 void HomeApp::deinit() {
-    if (screen) { lv_obj_del(screen); screen = nullptr; }
+    if (screen) {
+        WidgetPool::reclaim(screen);  // Borrowed widgets go back before the screen is deleted
+        lv_obj_del(screen);
+        screen = nullptr;
+    }
     initialized = false;
 }
 
 lv_obj_t* HomeApp::createScreen() {
-    lv_obj_t* scr = lv_obj_create(NULL);
-    lv_obj_t* title = lv_label_create(scr);
-    lv_label_set_text(title, "Home");
+    lv_obj_t* scr = LayoutLoader::load("home");
+    if (scr) return scr;
+    
+    // Built-in screen when no layout is installed
+    scr = lv_obj_create(NULL);
+    lv_obj_t* title = WidgetPool::label(scr);
+    lv_obj_add_style(title, UiStyles::title(), 0);
+    lv_label_set_text_static(title, "Home");
     lv_obj_align(title, LV_ALIGN_CENTER, 0, 0);
     return scr;
 }
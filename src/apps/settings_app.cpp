@@ -1,27 +1,77 @@
 #include "settings_app.h"
-#include "app_manager.h"
+#include "perf_overlay.h"
+#include "layout_loader.h"
+#include "widget_pool.h"
+#include "ui_styles.h"
 
 bool SettingsApp::init() {
     if (initialized) return true;
-    appManager.registerApp(this);
     screen = createScreen();
+    perfSwitch = (lv_obj_t*)lv_obj_get_user_data(screen);
+    lv_group_add_obj(inputGroup(), perfSwitch);
     initialized = true;
     return true;
 }
 
 void SettingsApp::deinit() {
-    if (screen) { lv_obj_del(screen); screen = nullptr; }
+    if (screen) {
+        WidgetPool::reclaim(screen);  // Borrowed widgets go back before the screen is deleted
+        lv_obj_del(screen);
+        screen = nullptr;
+    }
+    perfSwitch = nullptr;
     initialized = false;
 }
 
 lv_obj_t* SettingsApp::createScreen() {
-    lv_obj_t* scr = lv_obj_create(NULL);
-    lv_obj_t* title = lv_label_create(scr);
-    lv_label_set_text(title, "Settings");
-    lv_obj_align(title, LV_ALIGN_CENTER, 0, 0);
+    // Layout ids: 1 = perf overlay switch
+    lv_obj_t* ids[2];
+    lv_obj_t* scr = LayoutLoader::load("settings", ids, 2);
+    lv_obj_t* sw = scr ? ids[1] : nullptr;
+    if (scr && !sw) {
+        WidgetPool::reclaim(scr);  // Installed layout is missing the switch
+        lv_obj_del(scr);
+        scr = nullptr;
+    }
+    
+    if (!scr) {
+        // Built-in screen when no layout is installed
+        scr = lv_obj_create(NULL);
+        lv_obj_t* title = WidgetPool::label(scr);
+        lv_obj_add_style(title, UiStyles::title(), 0);
+        lv_label_set_text_static(title, "Settings");
+        lv_obj_align(title, LV_ALIGN_CENTER, 0, -40);
+        
+        lv_obj_t* perfLabel = WidgetPool::label(scr);
+        lv_obj_add_style(perfLabel, UiStyles::body(), 0);
+        lv_label_set_text_static(perfLabel, "Perf overlay");
+        lv_obj_align(perfLabel, LV_ALIGN_CENTER, -40, 10);
+        
+        sw = lv_switch_create(scr);
+        lv_obj_align(sw, LV_ALIGN_CENTER, 60, 10);
+    }
+    
+    // Keep createScreen() free of side effects - init() picks the switch up from here
+    lv_obj_add_event_cb(sw, onPerfSwitchChanged, LV_EVENT_VALUE_CHANGED, nullptr);
+    lv_obj_set_user_data(scr, sw);
     return scr;
 }
 
-void SettingsApp::onEnter() { if (screen) lv_scr_load(screen); }
+void SettingsApp::onPerfSwitchChanged(lv_event_t* e) {
+    lv_obj_t* sw = lv_event_get_target(e);
+    PerfOverlay::setEnabled(lv_obj_has_state(sw, LV_STATE_CHECKED));
+}
+
+void SettingsApp::onEnter() {
+    if (!screen) return;
+    
+    // The overlay can also be toggled from the serial console - reflect its current state
+    if (PerfOverlay::isEnabled()) {
+        lv_obj_add_state(perfSwitch, LV_STATE_CHECKED);
+    } else {
+        lv_obj_clear_state(perfSwitch, LV_STATE_CHECKED);
+    }
+    lv_scr_load(screen);
+}
 void SettingsApp::onExit() {}
 void SettingsApp::update() {}
@@ -1,30 +1,97 @@
 #include "weather_app.h"
-#include "app_manager.h"
+#include "layout_loader.h"
+#include "widget_pool.h"
+#include "ui_styles.h"
+#include "mqtt_manager.h"
 
 bool WeatherApp::init() {
     if (initialized) return true;
-    
-    // Register this app with the AppManager
-    appManager.registerApp(this);
-    
+
     screen = createScreen();
+    lv_obj_t* value = (lv_obj_t*)lv_obj_get_user_data(screen);
+    readout = UiUpdateQueue::bind(value);
+
+    // Bound first: a fold after this copy also posts through the handle
+    char shown[sizeof(text)];
+    portENTER_CRITICAL(&modelLock);
+    memcpy(shown, text, sizeof(shown));
+    portEXIT_CRITICAL(&modelLock);
+    lv_label_set_text(value, shown);
     initialized = true;
     return true;
 }
 
 void WeatherApp::deinit() {
-    if (screen) { lv_obj_del(screen); screen = nullptr; }
+    UiUpdateQueue::unbind(readout);
+    readout = UI_HANDLE_NONE;
+    if (screen) {
+        WidgetPool::reclaim(screen);  // Borrowed widgets go back before the screen is deleted
+        lv_obj_del(screen);
+        screen = nullptr;
+    }
     initialized = false;
 }
 
 lv_obj_t* WeatherApp::createScreen() {
-    lv_obj_t* scr = lv_obj_create(NULL);
-    lv_obj_t* title = lv_label_create(scr);
-    lv_label_set_text(title, "Weather");
-    lv_obj_align(title, LV_ALIGN_CENTER, 0, 0);
+    // Layout ids: 1 = value label
+    lv_obj_t* ids[2];
+    lv_obj_t* scr = LayoutLoader::load("weather", ids, 2);
+    lv_obj_t* value = scr ? ids[1] : nullptr;
+    if (scr && !value) {
+        WidgetPool::reclaim(scr);  // Installed layout is missing the value label
+        lv_obj_del(scr);
+        scr = nullptr;
+    }
+    
+    if (!scr) {
+        // Built-in screen when no layout is installed
+        scr = lv_obj_create(NULL);
+        lv_obj_t* title = WidgetPool::label(scr);
+        lv_obj_add_style(title, UiStyles::title(), 0);
+        lv_label_set_text_static(title, "Weather");
+        lv_obj_align(title, LV_ALIGN_CENTER, 0, -30);
+        
+        value = WidgetPool::label(scr);
+        lv_obj_add_style(value, UiStyles::body(), 0);
+        lv_label_set_text_static(value, "--");
+        lv_obj_align(value, LV_ALIGN_CENTER, 0, 20);
+    }
+    
+    // Keep createScreen() free of side effects - init() binds the label from here
+    lv_obj_set_user_data(scr, value);
     return scr;
 }
 
 void WeatherApp::onEnter() { if (screen) lv_scr_load(screen); }
 void WeatherApp::onExit() {}
 void WeatherApp::update() {}
+
+void WeatherApp::onWeatherData(const JsonDocument& doc) {
+    // Only the model - a burst of messages costs one fold and one redraw
+    float newTemperature = mqttManager.extractFloatFromJson(doc, "temperature", 0.0);
+    int newHumidity = mqttManager.extractIntFromJson(doc, "humidity", 0);
+    portENTER_CRITICAL(&modelLock);
+    temperature = newTemperature;
+    humidity = newHumidity;
+    fresh = true;
+    portEXIT_CRITICAL(&modelLock);
+}
+
+void WeatherApp::updateBackground() {
+    portENTER_CRITICAL(&modelLock);
+    bool changed = fresh;
+    float t = temperature;
+    int h = humidity;
+    fresh = false;
+    portEXIT_CRITICAL(&modelLock);
+    if (!changed) return;
+
+    char formatted[sizeof(text)];
+    snprintf(formatted, sizeof(formatted), "%.1f C  %d%%", t, h);
+    portENTER_CRITICAL(&modelLock);
+    memcpy(text, formatted, sizeof(text));
+    portEXIT_CRITICAL(&modelLock);
+
+    // Dropped while the screen is evicted; init() renders the text instead
+    UiUpdateQueue::setText(readout, formatted);
+}
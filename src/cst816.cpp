@@ -1,27 +1,85 @@
 #include "cst816.h"
 #include "esp_err.h"
+#include "esp_attr.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "lcd_config.h"
+#include "touch_gesture.h"
+#include "touch_trace.h"
+#include "input_frame.h"
+#include "ui_scheduler.h"
 
 #define TEST_I2C_PORT I2C_NUM_0
 
+#define TOUCH_WRITE_MAX       16   // Longest register write, register byte excluded
+#define TOUCH_REPORT_LEN      7    // Gesture, finger count and the first point from register 0x00
+#define TOUCH_TASK_STACK      2560
+#define TOUCH_TASK_PRIO       3
+#define TOUCH_RELEASE_MS      60   // No INT for this long while touched - read once to confirm the lift
+
+typedef struct
+{
+  uint8_t pressed;
+  uint16_t x;
+  uint16_t y;
+} touch_sample_t;
+
+// Fixed transfer buffers - the bus is only ever used by one task at a time
+static uint8_t s_write_buf[TOUCH_WRITE_MAX + 1];
+static uint8_t s_report_buf[TOUCH_REPORT_LEN];
+
+static touch_sample_t s_sample = {0, 0, 0};
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task = NULL;
+static bool s_interrupt_mode = false;
+static touch_gesture_t s_gesture;
+
+// Updated from the INT handler, the touch task and the LVGL task, read from
+// the console - every access goes through s_stats_lock
+static touch_stats_t s_stats = {};
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void touch_count(uint32_t *counter, uint32_t n)
+{
+  portENTER_CRITICAL(&s_stats_lock);
+  *counter += n;
+  portEXIT_CRITICAL(&s_stats_lock);
+}
+
+// Every transfer is timed, so the two modes can be compared from the stats
+static void touch_account(int64_t start, esp_err_t err)
+{
+  uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+  portENTER_CRITICAL(&s_stats_lock);
+  s_stats.bus_us += us;
+  if (us > s_stats.max_read_us)
+    s_stats.max_read_us = us;
+  if (err != ESP_OK)
+    s_stats.errors++;
+  portEXIT_CRITICAL(&s_stats_lock);
+}
+
 uint8_t I2C_writr_buff(uint8_t addr,uint8_t reg,uint8_t *buf,uint8_t len)
 {
-  uint8_t ret;
-  uint8_t *pbuf = (uint8_t*)malloc(len+1);
-  pbuf[0] = reg;
+  if (len > TOUCH_WRITE_MAX)
+    return ESP_ERR_INVALID_SIZE;
+  s_write_buf[0] = reg;
   for(uint8_t i = 0; i<len; i++)
   {
-    pbuf[i+1] = buf[i];
+    s_write_buf[i+1] = buf[i];
   }
-  ret = i2c_master_write_to_device(TEST_I2C_PORT,addr,pbuf,len+1,1000);
-  free(pbuf);
-  pbuf = NULL;
+  int64_t start = esp_timer_get_time();
+  esp_err_t ret = i2c_master_write_to_device(TEST_I2C_PORT,addr,s_write_buf,len+1,1000);
+  touch_account(start, ret);
   return ret;
 }
 uint8_t I2C_read_buff(uint8_t addr,uint8_t reg,uint8_t *buf,uint8_t len)
 {
-  uint8_t ret;
-  ret = i2c_master_write_read_device(TEST_I2C_PORT,addr,&reg,1,buf,len,1000);
+  int64_t start = esp_timer_get_time();
+  esp_err_t ret = i2c_master_write_read_device(TEST_I2C_PORT,addr,&reg,1,buf,len,1000);
+  touch_account(start, ret);
   return ret;
 }
 uint8_t I2C_master_write_read_device(uint8_t addr,uint8_t *writeBuf,uint8_t writeLen,uint8_t *readBuf,uint8_t readLen)
@@ -30,7 +88,111 @@ uint8_t I2C_master_write_read_device(uint8_t addr,uint8_t *writeBuf,uint8_t writ
   ret = i2c_master_write_read_device(TEST_I2C_PORT,addr,writeBuf,writeLen,readBuf,readLen,1000);
   return ret;
 }
-void Touch_Init(void)
+
+// One coordinate read into the static report buffer
+static bool touch_read(touch_sample_t *sample)
+{
+  touch_count(&s_stats.reads, 1);
+  if (I2C_read_buff(EXAMPLE_TOUCH_ADDR,0x00,s_report_buf,TOUCH_REPORT_LEN) != ESP_OK)
+    return false;
+  sample->pressed = s_report_buf[2] ? 1 : 0;
+  if (sample->pressed)
+  {
+    sample->x = ((uint16_t)(s_report_buf[3] & 0x0f)<<8) + (uint16_t)s_report_buf[4];
+    sample->y = ((uint16_t)(s_report_buf[5] & 0x0f)<<8) + (uint16_t)s_report_buf[6];
+  }
+  return true;
+}
+
+// Every fresh sample goes to the gesture recognizer, in screen coordinates as LVGL sees them
+static void touch_process(const touch_sample_t *sample)
+{
+  int16_t x = 0, y = 0;
+  if (sample->pressed)
+  {
+#ifdef EXAMPLE_Rotate_90
+    x = sample->y;
+    y = EXAMPLE_LCD_V_RES - sample->x;
+#else
+    x = sample->x;
+    y = sample->y;
+#endif
+  }
+  touch_trace_record(sample->pressed, x, y);
+
+  touch_gesture_event_t events[TOUCH_GESTURE_MAX_EVENTS];
+  int n = touch_gesture_feed(&s_gesture, sample->pressed, x, y, (uint32_t)esp_timer_get_time(), events);
+  if (n == 0)
+    return;
+  for (int i = 0; i < n; i++)
+    input_frame_gesture(&events[i]);
+  touch_count(&s_stats.gestures, (uint32_t)n);
+  ui_scheduler_notify(UI_EVENT_INPUT);
+}
+
+static void IRAM_ATTR touch_isr(void *arg)
+{
+  portENTER_CRITICAL_ISR(&s_stats_lock);
+  s_stats.interrupts++;
+  portEXIT_CRITICAL_ISR(&s_stats_lock);
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(s_task, &woken);
+  if (woken)
+    portYIELD_FROM_ISR();
+}
+
+// The controller pulls INT low for every report while a finger is down, so
+// the bus is only used while someone is touching the screen
+static void touch_task(void *arg)
+{
+  touch_sample_t sample = {0, 0, 0};
+  while (1)
+  {
+    // The lift normally arrives as a report of its own; the timeout covers a missed one
+    TickType_t wait = sample.pressed ? pdMS_TO_TICKS(TOUCH_RELEASE_MS) : portMAX_DELAY;
+    ulTaskNotifyTake(pdTRUE, wait);
+    if (!touch_read(&sample))
+      continue;
+    touch_process(&sample);
+
+    portENTER_CRITICAL(&s_lock);
+    s_sample = sample;
+    portEXIT_CRITICAL(&s_lock);
+  }
+}
+
+// Always compiled so both modes build on every board; Touch_Init() picks one from the pin
+static bool touch_start_interrupt(gpio_num_t pin)
+{
+  gpio_config_t io = {};
+  io.pin_bit_mask = 1ULL << pin;
+  io.mode = GPIO_MODE_INPUT;
+  io.pull_up_en = GPIO_PULLUP_ENABLE;
+  io.intr_type = GPIO_INTR_NEGEDGE;
+  if (gpio_config(&io) != ESP_OK)
+    return false;
+
+  if (xTaskCreate(touch_task, "touch", TOUCH_TASK_STACK, NULL, TOUCH_TASK_PRIO, &s_task) != pdPASS)
+    return false;
+
+  // The service may already be installed by another driver
+  esp_err_t err = gpio_install_isr_service(0);
+  if (err == ESP_OK || err == ESP_ERR_INVALID_STATE)
+    err = gpio_isr_handler_add(pin, touch_isr, NULL);
+  if (err != ESP_OK)
+  {
+    vTaskDelete(s_task);
+    s_task = NULL;
+    gpio_reset_pin(pin);
+    return false;
+  }
+
+  // Pick up a finger that was already down before the first edge
+  xTaskNotifyGive(s_task);
+  return true;
+}
+
+bool Touch_Init(void)
 {
   i2c_config_t conf = 
   {
@@ -42,25 +204,72 @@ void Touch_Init(void)
     .master = {.clk_speed = 300 * 1000,},  // Select a frequency for the project
     .clk_flags = 0,          // Optionally, use the I2C SCLK SRC FLAG * flag to select the I2C source clock
   };
-  ESP_ERROR_CHECK(i2c_param_config(TEST_I2C_PORT, &conf));
-  ESP_ERROR_CHECK(i2c_driver_install(TEST_I2C_PORT, conf.mode,0,0,0));
+  if (ESP_ERROR_CHECK_WITHOUT_ABORT(i2c_param_config(TEST_I2C_PORT, &conf)) != ESP_OK)
+    return false;
+  if (ESP_ERROR_CHECK_WITHOUT_ABORT(i2c_driver_install(TEST_I2C_PORT, conf.mode,0,0,0)) != ESP_OK)
+    return false;
+
+  Touch_ResetStats();
+  touch_gesture_config_t gestures = TOUCH_GESTURE_CONFIG_DEFAULT;
+  gestures.center_x = EXAMPLE_LCD_H_RES / 2;
+  gestures.center_y = EXAMPLE_LCD_V_RES / 2;
+  touch_gesture_init(&s_gesture, &gestures);
 
   uint8_t data = 0x00;
   I2C_writr_buff(EXAMPLE_TOUCH_ADDR,0x00,&data,1); //Switch to normal mode
+
+  // No INT line (-1), or it could not be set up: every LVGL read polls the bus
+  int int_pin = EXAMPLE_PIN_NUM_TOUCH_INT;
+  s_interrupt_mode = int_pin >= 0 && GPIO_IS_VALID_GPIO(int_pin) && touch_start_interrupt((gpio_num_t)int_pin);
+  portENTER_CRITICAL(&s_stats_lock);
+  s_stats.interrupt_mode = s_interrupt_mode ? 1 : 0;
+  portEXIT_CRITICAL(&s_stats_lock);
+  return true;
 }
 uint8_t getTouch(uint16_t *x,uint16_t *y)
 {
-  uint8_t GetNum = 0;
-  uint8_t data[7] = {0};
-  I2C_read_buff(EXAMPLE_TOUCH_ADDR,0x00,data,7);
-  GetNum = data[2];
-  if(GetNum)
+  touch_count(&s_stats.polls, 1);
+  touch_sample_t sample;
+  if (s_interrupt_mode)
+  {
+    touch_count(&s_stats.cached, 1);
+    portENTER_CRITICAL(&s_lock);
+    sample = s_sample;
+    portEXIT_CRITICAL(&s_lock);
+  }
+  else if (touch_read(&sample))
+  {
+    touch_process(&sample);
+  }
+  else
+  {
+    return 0;
+  }
+
+  if (sample.pressed)
   {
-    *x = ((uint16_t)(data[3] & 0x0f)<<8) + (uint16_t)data[4];
-    *y = ((uint16_t)(data[5] & 0x0f)<<8) + (uint16_t)data[6];
+    *x = sample.x;
+    *y = sample.y;
     return 1;
   }
   return 0;
 }
 
+void Touch_GetStats(touch_stats_t *stats)
+{
+  portENTER_CRITICAL(&s_stats_lock);
+  *stats = s_stats;
+  portEXIT_CRITICAL(&s_stats_lock);
+}
+
+void Touch_ResetStats(void)
+{
+  uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+  portENTER_CRITICAL(&s_stats_lock);
+  s_stats = touch_stats_t();
+  s_stats.interrupt_mode = s_interrupt_mode ? 1 : 0;
+  s_stats.since_ms = now_ms;
+  portEXIT_CRITICAL(&s_stats_lock);
+}
+
 
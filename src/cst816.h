@@ -6,10 +6,29 @@
 extern "C" {
 #endif 
 
-void Touch_Init(void);
+// Transfer statistics, for comparing the interrupt and polling modes
+typedef struct
+{
+  uint8_t interrupt_mode;  // Reads follow the INT line; getTouch() serves the cached sample
+  uint32_t polls;          // getTouch() calls
+  uint32_t cached;         // getTouch() calls answered without touching the bus
+  uint32_t interrupts;     // INT falling edges
+  uint32_t reads;          // Coordinate reads over I2C
+  uint32_t errors;         // Failed transfers
+  uint64_t bus_us;         // Time spent waiting on I2C transfers
+  uint32_t max_read_us;
+  uint32_t gestures;       // Events from the gesture recognizer (touch_gesture.h)
+  uint32_t since_ms;       // millis() at the last reset
+} touch_stats_t;
+
+// Interrupt mode when EXAMPLE_PIN_NUM_TOUCH_INT (lcd_config.h) is a GPIO, polling otherwise
+bool Touch_Init(void);
 
 uint8_t getTouch(uint16_t *x,uint16_t *y);
 
+void Touch_GetStats(touch_stats_t *stats);
+void Touch_ResetStats(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,12 +13,26 @@
 #include "esp_attr.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "soc/soc_caps.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
 #include "bidi_switch_knob.h"
+#include "knob_decoder.h"
+
+#if SOC_PCNT_SUPPORTED
+#include "driver/pcnt.h"
+#define KNOB_PCNT_FILTER      1023 /*!< Glitch filter in APB cycles, the hardware maximum (~12.8 us) */
+#define KNOB_PCNT_LIMIT       100  /*!< Counting unit wraps here; reads must come within half of it */
+#define KNOB_PCNT_TASK_STACK  2560
+#define KNOB_PCNT_TASK_PRIO   5
+#define KNOB_PCNT_RING        16   /*!< Edge interrupts queued for the task */
+#endif
 
 static const char *TAG = "Knob";
 
 #define TICKS_INTERVAL 3
-#define DEBOUNCE_TICKS 2
 
 #define KNOB_CHECK(a, str, ret_val)                               \
     if (!(a))                                                     \
@@ -38,53 +52,71 @@ static const char *TAG = "Knob";
     if (knob->cb[ev])     \
     knob->cb[ev](knob, knob->usr_data[ev])
 
+#if SOC_PCNT_SUPPORTED
+/* One edge interrupt, as the PCNT task decodes it */
+typedef struct
+{
+    uint32_t time_us; /*!< When the interrupt ran */
+    int16_t falls;    /*!< Falling edges counted since the previous one, A positive, B negative */
+    uint8_t level_a;  /*!< A level read in the interrupt */
+    uint8_t level_b;  /*!< B level read in the interrupt */
+} knob_pcnt_edge_t;
+#endif
+
 typedef struct Knob
 {
-    bool encoder_a_change;                          /*<! true means Encoder A phase Inverted*/
-    bool encoder_b_change;                          /*<! true means Encoder B phase Inverted*/
-    uint8_t debounce_a_cnt;                         /*!< Encoder A phase debounce count */
-    uint8_t debounce_b_cnt;                         /*!< Encoder B phase debounce count */
-    uint8_t encoder_a_level;                        /*!< Encoder A phase current level */
-    uint8_t encoder_b_level;                        /*!< Encoder B phase current Level */
+    knob_backend_t backend;                         /*!< Backend driving this knob */
+    knob_decoder_t decoder;                         /*!< Debounce state and count */
     knob_event_t event;                             /*!< Current event */
-    int count_value;                                /*!< Knob count */
     uint8_t (*hal_knob_level)(void *hardware_data); /*!< Get current level */
     void *encoder_a;                                /*!< Encoder A phase gpio number */
     void *encoder_b;                                /*!< Encoder B phase gpio number */
+    uint64_t mask_a;                                /*!< Encoder A bit in the input snapshot */
+    uint64_t mask_b;                                /*!< Encoder B bit in the input snapshot */
     void *usr_data[KNOB_EVENT_MAX];                 /*!< User data for event */
     knob_cb_t cb[KNOB_EVENT_MAX];                   /*!< Event callback */
     struct Knob *next;                              /*!< Next pointer */
+#if SOC_PCNT_SUPPORTED
+    pcnt_unit_t pcnt_unit;                          /*!< Counting unit, read as a running count (PCNT backend) */
+    pcnt_unit_t pcnt_wake_unit;                     /*!< Wraps on every edge to raise an interrupt */
+    bool pcnt_running;                              /*!< Counter is not paused */
+    int16_t pcnt_last;                              /*!< Counting unit value at the last read */
+    knob_pcnt_edge_t ring[KNOB_PCNT_RING];          /*!< Edge interrupts not yet decoded */
+    uint8_t ring_head;                              /*!< Next entry to write */
+    uint8_t ring_count;                             /*!< Entries waiting */
+    TaskHandle_t task;                              /*!< Decodes queued edges and delivers callbacks */
+#endif
 } knob_dev_t;
 
+/*
+ * Batched sampling state: the pins of every timer knob, their levels at
+ * the last decoded tick, and whether any decoder was still debouncing.
+ */
+typedef struct
+{
+    uint64_t mask;
+    uint64_t last;
+    bool settling;
+} knob_sample_state_t;
+
 static knob_dev_t *s_head_handle = NULL;
 static esp_timer_handle_t s_knob_timer_handle;
 static bool s_is_timer_running = false;
+static knob_sampling_t s_sampling = KNOB_SAMPLING_BATCHED;
+static knob_sample_state_t s_sample_state = {0, 0, true};
 
-// 判定函数
-static void process_knob_channel(uint8_t current_level, uint8_t *prev_level,
-                                 uint8_t *debounce_cnt, int *count_value,
-                                 knob_event_t event, bool is_increment, knob_dev_t *knob)
+static void knob_emit(knob_dev_t *knob, int dir)
 {
-    if (current_level == 0)
+    if (dir > 0)
     {
-        if (current_level != *prev_level)
-            *debounce_cnt = 0;
-        else
-            (*debounce_cnt)++;
+        knob->event = KNOB_RIGHT;
+        CALL_EVENT_CB(KNOB_RIGHT);
     }
-    else
+    else if (dir < 0)
     {
-        if (current_level != *prev_level && ++(*debounce_cnt) >= DEBOUNCE_TICKS)
-        {
-            *debounce_cnt = 0;
-            *count_value += is_increment ? 1 : -1;
-            knob->event = event;
-            CALL_EVENT_CB(event);
-        }
-        else
-            *debounce_cnt = 0;
+        knob->event = KNOB_LEFT;
+        CALL_EVENT_CB(KNOB_LEFT);
     }
-    *prev_level = current_level;
 }
 
 static void knob_handler(knob_dev_t *knob)
@@ -92,25 +124,349 @@ static void knob_handler(knob_dev_t *knob)
     uint8_t pha_value = knob->hal_knob_level(knob->encoder_a);
     uint8_t phb_value = knob->hal_knob_level(knob->encoder_b);
 
-    process_knob_channel(pha_value, &knob->encoder_a_level,
-                         &knob->debounce_a_cnt, &knob->count_value,
-                         KNOB_RIGHT, true, knob);
+    knob_emit(knob, knob_decoder_sample(&knob->decoder, pha_value, phb_value, (uint32_t)esp_timer_get_time()));
+}
+
+static void knob_sample_per_pin(knob_dev_t *head)
+{
+    for (knob_dev_t *target = head; target; target = target->next)
+    {
+        if (target->backend == KNOB_BACKEND_TIMER)
+            knob_handler(target);
+    }
+}
 
-    process_knob_channel(phb_value, &knob->encoder_b_level,
-                         &knob->debounce_b_cnt, &knob->count_value,
-                         KNOB_LEFT, false, knob);
+// Both input registers in one word, bit n = GPIO n; the second is only read when a pin needs it
+static inline uint64_t knob_gpio_snapshot(uint64_t mask)
+{
+    uint64_t levels = REG_READ(GPIO_IN_REG);
+#if SOC_GPIO_PIN_COUNT > 32
+    if (mask >> 32)
+        levels |= (uint64_t)REG_READ(GPIO_IN1_REG) << 32;
+#endif
+    return levels & mask;
+}
+
+// Every knob decoded from one read, so A and B are always sampled together
+static void knob_sample_batched(knob_dev_t *head, knob_sample_state_t *state)
+{
+    uint64_t levels = knob_gpio_snapshot(state->mask);
+    // Nothing moved and no decoder is mid-debounce: another sample changes nothing
+    if (levels == state->last && !state->settling)
+        return;
+    state->last = levels;
+    state->settling = false;
+
+    uint32_t now_us = (uint32_t)esp_timer_get_time();
+    for (knob_dev_t *target = head; target; target = target->next)
+    {
+        if (target->backend != KNOB_BACKEND_TIMER)
+            continue;
+        int dir = knob_decoder_sample(&target->decoder, (levels & target->mask_a) != 0, (levels & target->mask_b) != 0, now_us);
+        knob_emit(target, dir);
+        if (!knob_decoder_idle(&target->decoder))
+            state->settling = true;
+    }
+}
+
+static uint64_t knob_timer_pin_mask(knob_dev_t *head)
+{
+    uint64_t mask = 0;
+    for (knob_dev_t *target = head; target; target = target->next)
+    {
+        if (target->backend == KNOB_BACKEND_TIMER)
+            mask |= target->mask_a | target->mask_b;
+    }
+    return mask;
+}
+
+// Call whenever a timer knob is added or removed
+static void knob_timer_update_mask(void)
+{
+    s_sample_state.mask = knob_timer_pin_mask(s_head_handle);
+    s_sample_state.settling = true;
 }
 
 // 这是timer的回调函数，定期执行
 static void knob_cb(void *args)
 {
-    knob_dev_t *target;
-    for (target = s_head_handle; target; target = target->next)
+    if (s_sampling == KNOB_SAMPLING_BATCHED)
+        knob_sample_batched(s_head_handle, &s_sample_state);
+    else
+        knob_sample_per_pin(s_head_handle);
+}
+
+static int knob_timer_count(void)
+{
+    int number = 0;
+    for (knob_dev_t *target = s_head_handle; target; target = target->next)
+    {
+        if (target->backend == KNOB_BACKEND_TIMER)
+            number++;
+    }
+    return number;
+}
+
+static esp_err_t knob_timer_start(void)
+{
+    if (!s_knob_timer_handle)
+    {
+        esp_timer_create_args_t knob_timer = {0};
+        knob_timer.arg = NULL;
+        knob_timer.callback = knob_cb;
+        knob_timer.dispatch_method = ESP_TIMER_TASK;
+        knob_timer.name = "knob_timer";
+        esp_err_t err = esp_timer_create(&knob_timer, &s_knob_timer_handle);
+        if (err != ESP_OK)
+            return err;
+    }
+
+    if (!s_is_timer_running)
+    {
+        esp_timer_start_periodic(s_knob_timer_handle, TICKS_INTERVAL * 1000U);
+        s_is_timer_running = true;
+    }
+    return ESP_OK;
+}
+
+#if SOC_PCNT_SUPPORTED
+/*
+ * PCNT backend: each knob takes two units on the same pins, both behind
+ * the glitch filter. The counting unit counts falling edges only, up on A
+ * and down on B. It is never cleared while it runs: it wraps to zero at
+ * +-KNOB_PCNT_LIMIT in hardware and is read as a running count, so no
+ * edge can fall between a read and a clear. The wake unit counts both
+ * edges with limits of +-1, so every edge wraps it and raises a limit
+ * event; its count is never read. The CPU does nothing while the knob is
+ * still. The interrupt queues the time, the falls since the last one and
+ * the line levels; the task hands each entry to the decoder straight
+ * away, which counts a detent on a line's first fall after a quiet
+ * release and treats the rest as bounce.
+ */
+static portMUX_TYPE s_pcnt_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_pcnt_units_used = 0; /*!< Bit per unit */
+static bool s_pcnt_isr_installed = false;
+
+// Counter values are the running count modulo KNOB_PCNT_LIMIT; fine while
+// fewer than KNOB_PCNT_LIMIT / 2 edges pass between two reads
+static int knob_pcnt_diff(int16_t value, int16_t last)
+{
+    int diff = value - last;
+    if (diff > KNOB_PCNT_LIMIT / 2)
+        diff -= KNOB_PCNT_LIMIT;
+    else if (diff < -KNOB_PCNT_LIMIT / 2)
+        diff += KNOB_PCNT_LIMIT;
+    return diff;
+}
+
+// Wake unit limit event: one or more edges since the last one
+static void knob_pcnt_isr(void *arg)
+{
+    knob_dev_t *knob = (knob_dev_t *)arg;
+    int16_t value = 0;
+    pcnt_get_counter_value(knob->pcnt_unit, &value);
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint8_t level_a = knob->hal_knob_level(knob->encoder_a);
+    uint8_t level_b = knob->hal_knob_level(knob->encoder_b);
+
+    portENTER_CRITICAL_ISR(&s_pcnt_lock);
+    int falls = knob_pcnt_diff(value, knob->pcnt_last);
+    knob->pcnt_last = value;
+    knob_pcnt_edge_t *edge;
+    if (knob->ring_count < KNOB_PCNT_RING)
+    {
+        edge = &knob->ring[knob->ring_head];
+        edge->falls = 0;
+        knob->ring_head = (uint8_t)((knob->ring_head + 1) % KNOB_PCNT_RING);
+        knob->ring_count++;
+    }
+    else
     {
-        knob_handler(target);
+        // Task behind: fold into the newest entry, the falls are kept
+        edge = &knob->ring[(knob->ring_head + KNOB_PCNT_RING - 1) % KNOB_PCNT_RING];
     }
+    edge->time_us = now;
+    edge->falls = (int16_t)(edge->falls + falls);
+    edge->level_a = level_a;
+    edge->level_b = level_b;
+    portEXIT_CRITICAL_ISR(&s_pcnt_lock);
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(knob->task, &woken);
+    if (woken)
+        portYIELD_FROM_ISR();
 }
 
+// Decoding and callbacks run here rather than in the ISR, as they did on the timer task
+static void knob_pcnt_task(void *arg)
+{
+    knob_dev_t *knob = (knob_dev_t *)arg;
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (1)
+        {
+            knob_pcnt_edge_t edge;
+            portENTER_CRITICAL(&s_pcnt_lock);
+            bool queued = knob->ring_count > 0;
+            if (queued)
+            {
+                edge = knob->ring[(knob->ring_head + KNOB_PCNT_RING - knob->ring_count) % KNOB_PCNT_RING];
+                knob->ring_count--;
+            }
+            portEXIT_CRITICAL(&s_pcnt_lock);
+            if (!queued)
+                break;
+
+            knob_emit(knob, knob_decoder_edges(&knob->decoder, edge.level_a, edge.level_b, edge.falls, edge.time_us));
+        }
+    }
+}
+
+// falls_only: count falling edges only (counting unit), else both (wake unit)
+static esp_err_t knob_pcnt_unit(pcnt_unit_t unit, const knob_config_t *config, int16_t limit, bool falls_only)
+{
+    pcnt_config_t cfg = {
+        .pulse_gpio_num = config->gpio_encoder_a,
+        .ctrl_gpio_num = PCNT_PIN_NOT_USED,
+        .lctrl_mode = PCNT_MODE_KEEP,
+        .hctrl_mode = PCNT_MODE_KEEP,
+        .pos_mode = falls_only ? PCNT_COUNT_DIS : PCNT_COUNT_INC,
+        .neg_mode = PCNT_COUNT_INC,
+        .counter_h_lim = limit,
+        .counter_l_lim = -limit,
+        .unit = unit,
+        .channel = PCNT_CHANNEL_0,
+    };
+    esp_err_t ret = pcnt_unit_config(&cfg);
+    if (ret != ESP_OK)
+        return ret;
+
+    cfg.pulse_gpio_num = config->gpio_encoder_b;
+    cfg.pos_mode = falls_only ? PCNT_COUNT_DIS : PCNT_COUNT_DEC;
+    cfg.neg_mode = PCNT_COUNT_DEC;
+    cfg.channel = PCNT_CHANNEL_1;
+    ret = pcnt_unit_config(&cfg);
+    if (ret != ESP_OK)
+        return ret;
+
+    pcnt_set_filter_value(unit, KNOB_PCNT_FILTER);
+    pcnt_filter_enable(unit);
+    pcnt_counter_pause(unit);
+    pcnt_counter_clear(unit);
+    return ESP_OK;
+}
+
+static int knob_pcnt_take_unit(void)
+{
+    for (int unit = 0; unit < PCNT_UNIT_MAX; unit++)
+    {
+        if (!(s_pcnt_units_used & (1u << unit)))
+        {
+            s_pcnt_units_used |= 1u << unit;
+            return unit;
+        }
+    }
+    return -1;
+}
+
+static void knob_pcnt_give_unit(pcnt_unit_t unit)
+{
+    s_pcnt_units_used &= ~(1u << unit);
+}
+
+// Both units paused and zeroed, so a resume starts the running count from nothing
+static void knob_pcnt_reset(knob_dev_t *knob)
+{
+    pcnt_counter_pause(knob->pcnt_wake_unit);
+    pcnt_counter_pause(knob->pcnt_unit);
+    pcnt_counter_clear(knob->pcnt_unit);
+    pcnt_counter_clear(knob->pcnt_wake_unit);
+    portENTER_CRITICAL(&s_pcnt_lock);
+    knob->pcnt_last = 0;
+    knob->ring_head = 0;
+    knob->ring_count = 0;
+    portEXIT_CRITICAL(&s_pcnt_lock);
+}
+
+static void knob_pcnt_start(knob_dev_t *knob)
+{
+    pcnt_counter_resume(knob->pcnt_unit);
+    pcnt_counter_resume(knob->pcnt_wake_unit);
+}
+
+static esp_err_t knob_pcnt_init(knob_dev_t *knob, const knob_config_t *config)
+{
+    int count_unit = knob_pcnt_take_unit();
+    int wake_unit = knob_pcnt_take_unit();
+    if (count_unit < 0 || wake_unit < 0)
+    {
+        if (count_unit >= 0)
+            knob_pcnt_give_unit((pcnt_unit_t)count_unit);
+        ESP_LOGE(TAG, "no free pulse counter units");
+        return ESP_ERR_NOT_FOUND;
+    }
+    knob->pcnt_unit = (pcnt_unit_t)count_unit;
+    knob->pcnt_wake_unit = (pcnt_unit_t)wake_unit;
+
+    BaseType_t created;
+    esp_err_t ret = knob_pcnt_unit(knob->pcnt_unit, config, KNOB_PCNT_LIMIT, true);
+    if (ret == ESP_OK)
+        ret = knob_pcnt_unit(knob->pcnt_wake_unit, config, 1, false);
+    KNOB_CHECK_GOTO(ESP_OK == ret, "pulse counter config failed", _give_units);
+
+    pcnt_event_enable(knob->pcnt_wake_unit, PCNT_EVT_H_LIM);
+    pcnt_event_enable(knob->pcnt_wake_unit, PCNT_EVT_L_LIM);
+
+    created = xTaskCreate(knob_pcnt_task, "knob_pcnt", KNOB_PCNT_TASK_STACK, knob, KNOB_PCNT_TASK_PRIO, &knob->task);
+    if (pdPASS != created)
+    {
+        ret = ESP_ERR_NO_MEM;
+        knob->task = NULL;
+        ESP_LOGE(TAG, "knob task create failed");
+        goto _disable_events;
+    }
+
+    if (!s_pcnt_isr_installed)
+    {
+        ret = pcnt_isr_service_install(0);
+        s_pcnt_isr_installed = ret == ESP_OK || ret == ESP_ERR_INVALID_STATE;
+    }
+    ret = s_pcnt_isr_installed ? pcnt_isr_handler_add(knob->pcnt_wake_unit, knob_pcnt_isr, knob) : ESP_FAIL;
+    KNOB_CHECK_GOTO(ESP_OK == ret, "pulse counter interrupt setup failed", _delete_task);
+
+    knob_pcnt_reset(knob);
+    knob->pcnt_running = true;
+    knob_pcnt_start(knob);
+    return ESP_OK;
+
+_delete_task:
+    vTaskDelete(knob->task);
+    knob->task = NULL;
+_disable_events:
+    pcnt_event_disable(knob->pcnt_wake_unit, PCNT_EVT_H_LIM);
+    pcnt_event_disable(knob->pcnt_wake_unit, PCNT_EVT_L_LIM);
+_give_units:
+    knob_pcnt_give_unit(knob->pcnt_unit);
+    knob_pcnt_give_unit(knob->pcnt_wake_unit);
+    return ret;
+}
+
+static void knob_pcnt_deinit(knob_dev_t *knob)
+{
+    knob_pcnt_reset(knob);
+    pcnt_event_disable(knob->pcnt_wake_unit, PCNT_EVT_H_LIM);
+    pcnt_event_disable(knob->pcnt_wake_unit, PCNT_EVT_L_LIM);
+    pcnt_isr_handler_remove(knob->pcnt_wake_unit);
+    if (knob->task)
+        vTaskDelete(knob->task);
+    knob->task = NULL;
+    // Back to the pool for the next knob
+    knob_pcnt_give_unit(knob->pcnt_unit);
+    knob_pcnt_give_unit(knob->pcnt_wake_unit);
+}
+#endif
+
 knob_handle_t iot_knob_create(const knob_config_t *config)
 {
     KNOB_CHECK(NULL != config, "config pointer can't be NULL!", NULL)
@@ -128,37 +484,46 @@ knob_handle_t iot_knob_create(const knob_config_t *config)
     knob->hal_knob_level = knob_gpio_get_key_level;
     knob->encoder_a = (void *)(long)config->gpio_encoder_a;
     knob->encoder_b = (void *)(long)config->gpio_encoder_b;
+    knob->mask_a = 1ULL << config->gpio_encoder_a;
+    knob->mask_b = 1ULL << config->gpio_encoder_b;
 
-    knob->encoder_a_level = knob->hal_knob_level(knob->encoder_a);
-    knob->encoder_b_level = knob->hal_knob_level(knob->encoder_b);
+    knob_decoder_init(&knob->decoder, config->decoder, knob->hal_knob_level(knob->encoder_a), knob->hal_knob_level(knob->encoder_b));
 
     knob->event = KNOB_NONE;
+    knob->backend = KNOB_BACKEND_TIMER;
 
-    knob->next = s_head_handle;
-    s_head_handle = knob;
-
-    if (!s_knob_timer_handle)
+#if SOC_PCNT_SUPPORTED
+    // Counted edges carry no direction of their own; a bidirectional switch gives it by line
+    if (config->backend == KNOB_BACKEND_PCNT && config->decoder == KNOB_DECODER_BIDI)
     {
-        esp_timer_create_args_t knob_timer = {0};
-        knob_timer.arg = NULL;
-        knob_timer.callback = knob_cb;
-        knob_timer.dispatch_method = ESP_TIMER_TASK;
-        knob_timer.name = "knob_timer";
-        esp_timer_create(&knob_timer, &s_knob_timer_handle);
+        if (knob_pcnt_init(knob, config) == ESP_OK)
+            knob->backend = KNOB_BACKEND_PCNT;
+        else
+            ESP_LOGW(TAG, "pulse counter unavailable, sampling with the timer");
     }
+#endif
 
-    if (!s_is_timer_running)
+    knob->next = s_head_handle;
+    s_head_handle = knob;
+    knob_timer_update_mask();
+
+    if (knob->backend == KNOB_BACKEND_TIMER)
     {
-        esp_timer_start_periodic(s_knob_timer_handle, TICKS_INTERVAL * 1000U);
-        s_is_timer_running = true;
+        ret = knob_timer_start();
+        KNOB_CHECK_GOTO(ESP_OK == ret, "knob timer create failed", _knob_unlink);
     }
 
-    ESP_LOGI(TAG, "Iot Knob Config Succeed, encoder A:%d, encoder B:%d", config->gpio_encoder_a, config->gpio_encoder_b);
+    ESP_LOGI(TAG, "Iot Knob Config Succeed, encoder A:%d, encoder B:%d, %s", config->gpio_encoder_a, config->gpio_encoder_b,
+             knob->backend == KNOB_BACKEND_PCNT ? "pulse counter" : "timer");
     return (knob_handle_t)knob;
 
+_knob_unlink:
+    s_head_handle = knob->next;
+    knob_timer_update_mask();
 _encoder_deinit:
     knob_gpio_deinit(config->gpio_encoder_b);
     knob_gpio_deinit(config->gpio_encoder_a);
+    free(knob);
     return NULL;
 }
 
@@ -167,7 +532,13 @@ esp_err_t iot_knob_delete(knob_handle_t knob_handle)
     esp_err_t ret = ESP_OK;
     KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
     knob_dev_t *knob = (knob_dev_t *)knob_handle;
-    ret = knob_gpio_deinit((int)(knob->usr_data));
+#if SOC_PCNT_SUPPORTED
+    if (knob->backend == KNOB_BACKEND_PCNT)
+        knob_pcnt_deinit(knob);
+#endif
+    ret = knob_gpio_deinit((uint32_t)(long)knob->encoder_a);
+    if (ESP_OK == ret)
+        ret = knob_gpio_deinit((uint32_t)(long)knob->encoder_b);
     KNOB_CHECK(ESP_OK == ret, "knob deinit failed", ESP_FAIL);
     knob_dev_t **curr;
     for (curr = &s_head_handle; *curr;)
@@ -184,19 +555,16 @@ esp_err_t iot_knob_delete(knob_handle_t knob_handle)
         }
     }
 
-    uint16_t number = 0;
-    knob_dev_t *target = s_head_handle;
-    while (target)
-    {
-        target = target->next;
-        number++;
-    }
-    ESP_LOGD(TAG, "remain knob number=%d", number);
+    knob_timer_update_mask();
+    uint16_t number = knob_timer_count();
+    ESP_LOGD(TAG, "remain timer knob number=%d", number);
 
-    if (0 == number && s_is_timer_running)
+    if (0 == number && s_knob_timer_handle)
     {
-        esp_timer_stop(s_knob_timer_handle);
+        if (s_is_timer_running)
+            esp_timer_stop(s_knob_timer_handle);
         esp_timer_delete(s_knob_timer_handle);
+        s_knob_timer_handle = NULL;
         s_is_timer_running = false;
     }
 
@@ -234,19 +602,172 @@ int iot_knob_get_count_value(knob_handle_t knob_handle)
 {
     KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
     knob_dev_t *knob = (knob_dev_t *)knob_handle;
-    return knob->count_value;
+    return knob->decoder.count;
 }
 
 esp_err_t iot_knob_clear_count_value(knob_handle_t knob_handle)
 {
     KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
     knob_dev_t *knob = (knob_dev_t *)knob_handle;
-    knob->count_value = 0;
+    knob->decoder.count = 0;
+    knob->decoder.accel_count = 0;
     return ESP_OK;
 }
 
+int iot_knob_get_accel_count_value(knob_handle_t knob_handle)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    return knob->decoder.accel_count;
+}
+
+int iot_knob_get_last_delta(knob_handle_t knob_handle)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    return knob->decoder.last_delta;
+}
+
+uint32_t iot_knob_get_velocity(knob_handle_t knob_handle)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    return knob_decoder_velocity(&knob->decoder, (uint32_t)esp_timer_get_time());
+}
+
+esp_err_t iot_knob_set_accel_curve(knob_handle_t knob_handle, const knob_accel_curve_t *curve)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
+    KNOB_CHECK(NULL != curve, "curve pointer can't be NULL!", ESP_ERR_INVALID_ARG);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    knob_decoder_set_accel(&knob->decoder, curve);
+    return ESP_OK;
+}
+
+esp_err_t iot_knob_get_accel_curve(knob_handle_t knob_handle, knob_accel_curve_t *curve)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
+    KNOB_CHECK(NULL != curve, "curve pointer can't be NULL!", ESP_ERR_INVALID_ARG);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    *curve = knob->decoder.accel;
+    return ESP_OK;
+}
+
+knob_backend_t iot_knob_get_backend(knob_handle_t knob_handle)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    return knob->backend;
+}
+
+esp_err_t iot_knob_get_stats(knob_handle_t knob_handle, uint32_t *accepted, uint32_t *rejected, uint32_t *invalid)
+{
+    KNOB_CHECK(NULL != knob_handle, "Pointer of handle is invalid", ESP_ERR_INVALID_ARG);
+    knob_dev_t *knob = (knob_dev_t *)knob_handle;
+    if (accepted)
+        *accepted = knob->decoder.accepted;
+    if (rejected)
+        *rejected = knob->decoder.rejected;
+    if (invalid)
+        *invalid = knob->decoder.invalid;
+    return ESP_OK;
+}
+
+esp_err_t iot_knob_set_sampling(knob_sampling_t sampling)
+{
+    KNOB_CHECK(sampling == KNOB_SAMPLING_BATCHED || sampling == KNOB_SAMPLING_PER_PIN, "sampling mode is invalid", ESP_ERR_INVALID_ARG);
+    // Decode the first batched tick in full rather than trusting a stale snapshot
+    s_sample_state.settling = true;
+    s_sampling = sampling;
+    return ESP_OK;
+}
+
+knob_sampling_t iot_knob_get_sampling(void)
+{
+    return s_sampling;
+}
+
+static uint32_t knob_bench_ns(int64_t start_us, int ticks)
+{
+    return (uint32_t)((esp_timer_get_time() - start_us) * 1000 / ticks);
+}
+
+esp_err_t iot_knob_bench_tick(int knobs, int ticks, knob_bench_t *result)
+{
+    KNOB_CHECK(knobs > 0 && ticks > 0 && NULL != result, "bench arguments are invalid", ESP_ERR_INVALID_ARG);
+    KNOB_CHECK(NULL != s_head_handle, "no knob to take pins from", ESP_ERR_INVALID_STATE);
+
+    knob_dev_t *scratch = (knob_dev_t *)calloc(knobs, sizeof(knob_dev_t));
+    KNOB_CHECK(NULL != scratch, "alloc scratch knobs failed", ESP_ERR_NO_MEM);
+
+    // Same pins as a real knob, no callbacks, never linked into s_head_handle
+    const knob_dev_t *real = s_head_handle;
+    for (int i = 0; i < knobs; i++)
+    {
+        knob_dev_t *knob = &scratch[i];
+        knob->backend = KNOB_BACKEND_TIMER;
+        knob->hal_knob_level = real->hal_knob_level;
+        knob->encoder_a = real->encoder_a;
+        knob->encoder_b = real->encoder_b;
+        knob->mask_a = real->mask_a;
+        knob->mask_b = real->mask_b;
+        knob_decoder_init(&knob->decoder, real->decoder.mode, knob->hal_knob_level(knob->encoder_a), knob->hal_knob_level(knob->encoder_b));
+        knob->next = i + 1 < knobs ? &scratch[i + 1] : NULL;
+    }
+
+    knob_sample_state_t state = {knob_timer_pin_mask(scratch), 0, true};
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < ticks; i++)
+        knob_sample_per_pin(scratch);
+    result->per_pin_ns = knob_bench_ns(start, ticks);
+
+    // A moving knob keeps a decoder debouncing, so every tick decodes every knob
+    start = esp_timer_get_time();
+    for (int i = 0; i < ticks; i++)
+    {
+        state.settling = true;
+        knob_sample_batched(scratch, &state);
+    }
+    result->batched_ns = knob_bench_ns(start, ticks);
+
+    state.settling = false;
+    start = esp_timer_get_time();
+    for (int i = 0; i < ticks; i++)
+        knob_sample_batched(scratch, &state);
+    result->idle_ns = knob_bench_ns(start, ticks);
+
+    free(scratch);
+    return ESP_OK;
+}
+
+#if SOC_PCNT_SUPPORTED
+static int knob_pcnt_set_running(bool running)
+{
+    int changed = 0;
+    for (knob_dev_t *target = s_head_handle; target; target = target->next)
+    {
+        if (target->backend != KNOB_BACKEND_PCNT || target->pcnt_running == running)
+            continue;
+        // Edges while paused are dropped, as the timer backend drops them while stopped
+        knob_pcnt_reset(target);
+        if (running)
+            knob_pcnt_start(target);
+        target->pcnt_running = running;
+        changed++;
+    }
+    return changed;
+}
+#else
+static int knob_pcnt_set_running(bool running)
+{
+    return 0;
+}
+#endif
+
 esp_err_t iot_knob_resume(void)
 {
+    if (knob_pcnt_set_running(true) && !s_knob_timer_handle)
+        return ESP_OK;
     KNOB_CHECK(s_knob_timer_handle, "knob timer handle is invalid", ESP_ERR_INVALID_STATE);
     KNOB_CHECK(!s_is_timer_running, "knob timer is already running", ESP_ERR_INVALID_STATE);
 
@@ -258,6 +779,8 @@ esp_err_t iot_knob_resume(void)
 
 esp_err_t iot_knob_stop(void)
 {
+    if (knob_pcnt_set_running(false) && !s_knob_timer_handle)
+        return ESP_OK;
     KNOB_CHECK(s_knob_timer_handle, "knob timer handle is invalid", ESP_ERR_INVALID_STATE);
     KNOB_CHECK(s_is_timer_running, "knob timer is not running", ESP_ERR_INVALID_STATE);
 
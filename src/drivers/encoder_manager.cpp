@@ -1,29 +1,43 @@
 #include "encoder_manager.h"
 #include "lcd_config.h"
+#include "ui_scheduler.h"
+#include <Preferences.h>
+#include "esp_timer.h"
 
-// Volos-style bit manipulation macros
-#define SET_BIT(reg,bit) (reg |= ((uint32_t)0x01<<bit))
-#define CLEAR_BIT(reg,bit) (reg &= (~((uint32_t)0x01<<bit)))
-#define READ_BIT(reg,bit) (((uint32_t)reg>>bit) & 0x01)
-#define BIT_EVEN_ALL (0x00ffffff)
+// Pulse counter by default; the driver falls back to timer sampling by itself
+#ifndef ENCODER_KNOB_BACKEND
+#define ENCODER_KNOB_BACKEND KNOB_BACKEND_PCNT
+#endif
 
 // Static member definitions
-EventGroupHandle_t EncoderManager::knob_even_ = NULL;
 knob_handle_t EncoderManager::s_knob = 0;
-SemaphoreHandle_t EncoderManager::mutex = NULL;
+TaskHandle_t EncoderManager::dispatchTask = NULL;
 
 // Simple callback
 EncoderChangeCallback EncoderManager::changeCallback = nullptr;
 
+EncoderManager::Listener EncoderManager::listeners[MAX_LISTENERS] = {};
+int EncoderManager::listenerCount = 0;
+
+SpscRing<EncoderEvent, EncoderManager::EVENT_RING_SIZE> EncoderManager::events;
+uint32_t EncoderManager::consumed = 0;
+uint32_t EncoderManager::batches = 0;
+uint32_t EncoderManager::maxBatch = 0;
+uint32_t EncoderManager::maxQueueUs = 0;
+uint64_t EncoderManager::totalLatencyUs = 0;
+uint64_t EncoderManager::busyUs = 0;
+
 bool EncoderManager::begin() {
-    // Initialize Volos's encoder system
-    mutex = xSemaphoreCreateMutex();
-    if (!mutex) {
-        return false;
-    }
-    
-    knob_even_ = xEventGroupCreate();
-    if (!knob_even_) {
+    // The dispatcher must exist before the first detent is pushed
+    BaseType_t result = xTaskCreate(
+        dispatchLoop,
+        "encoder_task",
+        DISPATCH_STACK,
+        NULL,
+        2,
+        &dispatchTask
+    );
+    if (result != pdPASS) {
         return false;
     }
     
@@ -31,12 +45,15 @@ bool EncoderManager::begin() {
     knob_config_t cfg = {
         .gpio_encoder_a = EXAMPLE_ENCODER_ECA_PIN,
         .gpio_encoder_b = EXAMPLE_ENCODER_ECB_PIN,
+        .backend = ENCODER_KNOB_BACKEND,
+        .decoder = KNOB_DECODER_BIDI,
     };
     s_knob = iot_knob_create(&cfg);
     
     if (!s_knob) {
         return false;
     }
+    loadAccelCurve();
     
     // Register Volos-style callbacks
     if (iot_knob_register_cb(s_knob, KNOB_LEFT, _knob_left_cb, NULL) != ESP_OK) {
@@ -47,17 +64,7 @@ bool EncoderManager::begin() {
         return false;
     }
     
-    // Start encoder task
-    BaseType_t result = xTaskCreate(
-        user_encoder_loop_task,
-        "encoder_task",
-        3000,
-        NULL,
-        2,
-        NULL
-    );
-    
-    return result == pdPASS;
+    return true;
 }
 
 void EncoderManager::end() {
@@ -66,14 +73,9 @@ void EncoderManager::end() {
         s_knob = 0;
     }
     
-    if (mutex) {
-        vSemaphoreDelete(mutex);
-        mutex = NULL;
-    }
-    
-    if (knob_even_) {
-        vEventGroupDelete(knob_even_);
-        knob_even_ = NULL;
+    if (dispatchTask) {
+        vTaskDelete(dispatchTask);
+        dispatchTask = NULL;
     }
 }
 
@@ -81,35 +83,202 @@ void EncoderManager::setChangeCallback(EncoderChangeCallback callback) {
     changeCallback = callback;
 }
 
+bool EncoderManager::addListener(EncoderBatchListener listener, void* ctx) {
+    if (!listener || listenerCount >= MAX_LISTENERS) {
+        return false;
+    }
+    listeners[listenerCount++] = { listener, ctx };
+    return true;
+}
+
+void EncoderManager::removeListener(EncoderBatchListener listener, void* ctx) {
+    for (int i = 0; i < listenerCount; i++) {
+        if (listeners[i].fn == listener && listeners[i].ctx == ctx) {
+            listeners[i] = listeners[--listenerCount];
+            return;
+        }
+    }
+}
+
 bool EncoderManager::isInitialized() {
     return s_knob != 0;
 }
 
-// Volos-style callbacks - simple and clean
-void EncoderManager::_knob_left_cb(void *arg, void *data) {
-    if (changeCallback) {
-        changeCallback(-1);  // Left = -1
-    }
+uint32_t EncoderManager::getVelocity() {
+    return s_knob ? iot_knob_get_velocity(s_knob) : 0;
 }
 
-void EncoderManager::_knob_right_cb(void *arg, void *data) {
-    if (changeCallback) {
-        changeCallback(1);   // Right = +1
+int EncoderManager::getCount() {
+    return s_knob ? iot_knob_get_count_value(s_knob) : 0;
+}
+
+int EncoderManager::getAcceleratedCount() {
+    return s_knob ? iot_knob_get_accel_count_value(s_knob) : 0;
+}
+
+void EncoderManager::loadAccelCurve() {
+    knob_accel_curve_t curve = KNOB_ACCEL_CURVE_DEFAULT;
+    Preferences prefs;
+    prefs.begin("config", true);
+    curve.start_dps = prefs.getUShort("knob_acc_start", curve.start_dps);
+    curve.full_dps = prefs.getUShort("knob_acc_full", curve.full_dps);
+    curve.max_mult = prefs.getUChar("knob_acc_max", curve.max_mult);
+    prefs.end();
+    iot_knob_set_accel_curve(s_knob, &curve);
+}
+
+bool EncoderManager::setAccelCurve(uint16_t startDps, uint16_t fullDps, uint8_t maxMult) {
+    if (fullDps <= startDps || maxMult < 1) {
+        return false;
     }
+    
+    knob_accel_curve_t curve = { startDps, fullDps, maxMult };
+    if (s_knob) {
+        iot_knob_set_accel_curve(s_knob, &curve);
+    }
+    
+    Preferences prefs;
+    prefs.begin("config", false);
+    prefs.putUShort("knob_acc_start", startDps);
+    prefs.putUShort("knob_acc_full", fullDps);
+    prefs.putUChar("knob_acc_max", maxMult);
+    prefs.end();
+    return true;
 }
 
-// Volos encoder task - just handles the event loop
-void EncoderManager::user_encoder_loop_task(void *arg) {
-    EventBits_t event_bit;
+void EncoderManager::printStatus() {
+    Serial.println("\n=== KNOB ===");
+    if (!s_knob) {
+        Serial.println("Encoder not initialized");
+        Serial.println("============\n");
+        return;
+    }
     
+    uint32_t accepted = 0, rejected = 0, invalid = 0;
+    iot_knob_get_stats(s_knob, &accepted, &rejected, &invalid);
+    knob_accel_curve_t curve;
+    iot_knob_get_accel_curve(s_knob, &curve);
+    if (iot_knob_get_backend(s_knob) == KNOB_BACKEND_PCNT) {
+        Serial.println("Backend:  pulse counter");
+    } else {
+        Serial.printf("Backend:  timer sampling (%s)\n",
+                      iot_knob_get_sampling() == KNOB_SAMPLING_BATCHED ? "batched register read" : "per pin");
+    }
+    Serial.printf("Count:    %d (accelerated %d)\n", iot_knob_get_count_value(s_knob), iot_knob_get_accel_count_value(s_knob));
+    Serial.printf("Speed:    %lu detents/s\n", iot_knob_get_velocity(s_knob));
+    Serial.printf("Accel:    x1 up to %u/s, x%u from %u/s\n", curve.start_dps, curve.max_mult, curve.full_dps);
+    Serial.printf("Steps:    %lu\n", accepted);
+    Serial.printf("Bounces:  %lu rejected, %lu invalid transitions\n", rejected, invalid);
+    Serial.printf("Events:   %lu queued, %lu consumed, %lu pending (max %lu of %lu)\n",
+                  events.getPushed(), consumed, events.size(), events.getHighWater(), events.capacity());
+    Serial.printf("Dropped:  %lu in %lu overflows\n", events.getDropped(), events.getOverflows());
+    Serial.printf("Batches:  %lu (largest %lu) - %lu callbacks saved\n",
+                  batches, maxBatch, consumed > batches ? consumed - batches : 0);
+    Serial.printf("Latency:  %lu us avg, %lu us worst (detent to listeners)\n",
+                  batches ? (uint32_t)(totalLatencyUs / batches) : 0, maxQueueUs);
+    Serial.printf("CPU:      %lu us in listeners, %lu us per batch\n",
+                  (uint32_t)busyUs, batches ? (uint32_t)(busyUs / batches) : 0);
+    if (dispatchTask) {
+        Serial.printf("Stack:    %u of %lu bytes never used\n",
+                      (unsigned)uxTaskGetStackHighWaterMark(dispatchTask), DISPATCH_STACK);
+    }
+    Serial.println("============\n");
+}
+
+void EncoderManager::resetStats() {
+    events.resetStats();
+    consumed = 0;
+    batches = 0;
+    maxBatch = 0;
+    maxQueueUs = 0;
+    totalLatencyUs = 0;
+    busyUs = 0;
+}
+
+// Runs on the knob driver's task (esp_timer or pulse counter) - only record
+// the detent and wake the dispatcher
+void EncoderManager::pushEvent(int direction) {
+    EncoderEvent event;
+    event.timeUs = (uint32_t)esp_timer_get_time();
+    event.direction = direction;
+    event.steps = iot_knob_get_last_delta(s_knob);
+    event.velocity = iot_knob_get_velocity(s_knob);
+    events.push(event);
+    if (dispatchTask) {
+        xTaskNotifyGive(dispatchTask);
+    }
+}
+
+// Sole consumer of the event ring. Sleeps until a detent arrives, then
+// folds everything queued since the last wakeup into one batch
+void EncoderManager::dispatchLoop(void *arg) {
     while (1) {
-        event_bit = xEventGroupWaitBits(knob_even_, BIT_EVEN_ALL, true, false, portMAX_DELAY);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         
-        if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
-            // Just handle the event bits - no click detection needed
-            xSemaphoreGive(mutex);
+        EncoderBatch batch = {};
+        EncoderEvent event;
+        while (events.pop(event)) {
+            if (batch.events == 0) batch.firstUs = event.timeUs;
+            batch.lastUs = event.timeUs;
+            batch.delta += event.direction;
+            batch.steps += event.steps;
+            batch.velocity = event.velocity;
+            batch.events++;
         }
+        if (batch.events == 0) continue;
         
-        vTaskDelay(pdMS_TO_TICKS(10));
+        uint32_t start = (uint32_t)esp_timer_get_time();
+        uint32_t latency = start - batch.firstUs;
+        deliver(batch);
+        busyUs += (uint32_t)esp_timer_get_time() - start;
+        
+        consumed += batch.events;
+        batches++;
+        totalLatencyUs += latency;
+        if (latency > maxQueueUs) maxQueueUs = latency;
+        if (batch.events > maxBatch) maxBatch = batch.events;
+    }
+}
+
+void EncoderManager::deliver(const EncoderBatch& batch) {
+    if (changeCallback && batch.delta != 0) {
+        changeCallback(batch.delta);
+    }
+    for (int i = 0; i < listenerCount; i++) {
+        listeners[i].fn(batch, listeners[i].ctx);
+    }
+    
+    // Listeners only record input; the UI task acts on it
+    UiScheduler::notify(UI_EVENT_INPUT);
+}
+
+// Volos-style callbacks - simple and clean
+void EncoderManager::_knob_left_cb(void *arg, void *data) {
+    pushEvent(-1);  // Left = -1
+}
+
+void EncoderManager::_knob_right_cb(void *arg, void *data) {
+    pushEvent(1);   // Right = +1
+}
+
+void EncoderManager::runTickBenchmark() {
+    static const int KNOB_COUNTS[] = { 1, 2, 4, 8, 16 };
+    static const int BENCH_TICKS = 2000;
+    
+    Serial.println("\n=== KNOB TICK BENCHMARK ===");
+    if (!s_knob) {
+        Serial.println("Encoder not initialized");
+        Serial.println("===========================\n");
+        return;
+    }
+    Serial.println("Knobs  per pin  batched  batched idle  (ns per tick)");
+    for (int knobs : KNOB_COUNTS) {
+        knob_bench_t bench;
+        if (iot_knob_bench_tick(knobs, BENCH_TICKS, &bench) != ESP_OK) {
+            Serial.printf("%5d  failed\n", knobs);
+            continue;
+        }
+        Serial.printf("%5d  %7lu  %7lu  %12lu\n", knobs, bench.per_pin_ns, bench.batched_ns, bench.idle_ns);
     }
+    Serial.println("===========================\n");
 }
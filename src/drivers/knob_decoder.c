@@ -0,0 +1,217 @@
+/*
+ * Knob step decoder shared by the knob backends.
+ *
+ * Extracted from process_knob_channel() in bidi_switch_knob.c and made
+ * table driven: both pins form one state, and a per-mode table says which
+ * state changes move the knob and which cannot happen.
+ */
+
+#include <string.h>
+#include "knob_decoder.h"
+
+#define REST 3 /* Both lines high (pulled up) */
+#define X    2 /* Invalid transition */
+
+// Indexed by (previous state << 2) | new state, state = (A << 1) | B.
+// A detent is counted when the pins return to REST.
+static const int8_t BIDI_TABLE[16] = {
+    0, X, X, X,   // 00 both low: never committed
+    X, 0, X, 1,   // 01 A low: only its release (a step right) is valid
+    X, X, 0, -1,  // 10 B low: only its release (a step left) is valid
+    X, 0, 0, 0,   // 11 rest: either line may start a pulse
+};
+
+// Gray code, clockwise 00 -> 01 -> 11 -> 10 -> 00; a both-bits change is invalid
+static const int8_t QUADRATURE_TABLE[16] = {
+    0, 1, -1, X,
+    -1, 0, X, 1,
+    1, X, 0, -1,
+    X, -1, 1, 0,
+};
+
+void knob_decoder_init(knob_decoder_t *dec, knob_decoder_mode_t mode, uint8_t level_a, uint8_t level_b)
+{
+    static const knob_accel_curve_t curve = KNOB_ACCEL_CURVE_DEFAULT;
+
+    memset(dec, 0, sizeof(*dec));
+    dec->mode = mode;
+    dec->accel = curve;
+    dec->state = (uint8_t)((level_a ? 2 : 0) | (level_b ? 1 : 0));
+    dec->candidate = dec->state;
+    dec->stable_cnt = KNOB_DECODER_DEBOUNCE_TICKS;
+}
+
+void knob_decoder_set_accel(knob_decoder_t *dec, const knob_accel_curve_t *curve)
+{
+    dec->accel = *curve;
+    if (dec->accel.max_mult < 1)
+        dec->accel.max_mult = 1;
+    if (dec->accel.full_dps <= dec->accel.start_dps)
+        dec->accel.full_dps = dec->accel.start_dps + 1;
+}
+
+int knob_decoder_accel_mult(const knob_accel_curve_t *curve, uint32_t dps)
+{
+    if (dps <= curve->start_dps || curve->max_mult <= 1)
+        return 1;
+    if (dps >= curve->full_dps)
+        return curve->max_mult;
+    uint32_t span = curve->full_dps - curve->start_dps;
+    return 1 + (int)((dps - curve->start_dps) * (uint32_t)(curve->max_mult - 1) / span);
+}
+
+// Timestamp a detent, update the speed estimate and the accelerated count
+static int detent(knob_decoder_t *dec, int dir, uint32_t now_us)
+{
+    uint32_t dt = now_us - dec->last_detent_us;
+    if (dec->last_dir == dir && dt < KNOB_DECODER_IDLE_US)
+    {
+        uint32_t instant = dt ? (16000000u / dt) : (KNOB_DECODER_MAX_DPS << 4);
+        if (instant > (KNOB_DECODER_MAX_DPS << 4))
+            instant = KNOB_DECODER_MAX_DPS << 4;
+        // Exponential average, weight 1/4 - one fast detent alone barely accelerates
+        int32_t diff = (int32_t)instant - (int32_t)dec->velocity_q4;
+        dec->velocity_q4 = (uint32_t)((int32_t)dec->velocity_q4 + diff / 4);
+    }
+    else
+    {
+        // First detent of a spin or a reversal: no speed yet
+        dec->velocity_q4 = 0;
+    }
+    dec->last_detent_us = now_us;
+    dec->last_dir = (int8_t)dir;
+
+    int steps = knob_decoder_accel_mult(&dec->accel, dec->velocity_q4 >> 4);
+    dec->last_delta = (int8_t)(dir * steps);
+    dec->count += dir;
+    dec->accel_count += dir * steps;
+    dec->accepted++;
+    return dir;
+}
+
+// Apply one settled pin state to the transition table
+static int commit(knob_decoder_t *dec, uint8_t input, uint32_t now_us)
+{
+    const int8_t *table = dec->mode == KNOB_DECODER_QUADRATURE ? QUADRATURE_TABLE : BIDI_TABLE;
+    int8_t move = table[(dec->state << 2) | input];
+    if (move == X)
+    {
+        // Keep the last good state; the pins must come back through a valid path
+        dec->invalid++;
+        return 0;
+    }
+
+    dec->state = input;
+    dec->sub_steps += move;
+    if (input != REST)
+        return 0;
+
+    // Back at rest: a full detent if enough of the cycle went one way
+    int threshold = dec->mode == KNOB_DECODER_QUADRATURE ? 2 : 1;
+    int sub = dec->sub_steps;
+    dec->sub_steps = 0;
+    if (sub >= threshold)
+        return detent(dec, 1, now_us);
+    if (sub <= -threshold)
+        return detent(dec, -1, now_us);
+    return 0;
+}
+
+int knob_decoder_sample(knob_decoder_t *dec, uint8_t level_a, uint8_t level_b, uint32_t now_us)
+{
+    uint8_t input = (uint8_t)((level_a ? 2 : 0) | (level_b ? 1 : 0));
+
+    if (input != dec->candidate)
+    {
+        // The previous candidate changed again before it settled
+        if (dec->candidate != dec->state && dec->stable_cnt < KNOB_DECODER_DEBOUNCE_TICKS)
+            dec->rejected++;
+        dec->candidate = input;
+        dec->stable_cnt = 0;
+    }
+    if (dec->stable_cnt < 255)
+        dec->stable_cnt++;
+
+    // Judge each settled state once
+    if (dec->stable_cnt != KNOB_DECODER_DEBOUNCE_TICKS || input == dec->state)
+        return 0;
+    return commit(dec, input, now_us);
+}
+
+bool knob_decoder_idle(const knob_decoder_t *dec)
+{
+    // Past the debounce a repeated sample only saturates stable_cnt
+    return dec->stable_cnt >= KNOB_DECODER_DEBOUNCE_TICKS;
+}
+
+// Press state of one line (counter backend)
+#define LINE_UP      0 /* Released, or never pressed */
+#define LINE_COUNTED 1 /* Low, detent already counted */
+#define LINE_PENDING 2 /* Low after too short a release - counted if it holds */
+
+// One line's edges since the last interrupt: falls counted, level now
+static int line_edges(knob_decoder_t *dec, int line, int dir, uint32_t falls, uint8_t level, uint32_t now_us)
+{
+    uint8_t bit = line == 0 ? 2 : 1;
+    bool was_low = !(dec->state & bit);
+    if (!falls && !was_low == !!level)
+        return 0;
+
+    // Time the line held its previous level
+    uint32_t held = (uint32_t)(now_us - dec->line_edge_us[line]);
+    bool long_hold = !(dec->lines_seen & bit) || held >= KNOB_DECODER_REARM_US;
+    dec->line_edge_us[line] = now_us;
+    dec->lines_seen |= bit;
+
+    int result = 0;
+    if (falls)
+    {
+        // Released long enough: a new detent, reported now
+        if (!was_low && long_hold)
+        {
+            result = detent(dec, dir, now_us);
+            dec->line_press[line] = LINE_COUNTED;
+            falls--;
+        }
+        else if (!was_low && dec->line_press[line] == LINE_UP)
+        {
+            // Release bounce or a new press - decided by how long it holds
+            dec->line_press[line] = LINE_PENDING;
+        }
+        dec->rejected += falls;
+        if (level && dec->line_press[line] == LINE_PENDING)
+            dec->line_press[line] = LINE_UP; // Up again within this interrupt: bounce
+        return result;
+    }
+
+    // Rise: a low that held is a press, and ends it
+    if (long_hold)
+    {
+        if (dec->line_press[line] == LINE_PENDING)
+            result = detent(dec, dir, now_us);
+        dec->line_press[line] = LINE_UP;
+    }
+    else if (dec->line_press[line] == LINE_PENDING)
+    {
+        dec->line_press[line] = LINE_UP;
+    }
+    return result;
+}
+
+int knob_decoder_edges(knob_decoder_t *dec, uint8_t level_a, uint8_t level_b, int falls, uint32_t now_us)
+{
+    uint32_t falls_a = falls > 0 ? (uint32_t)falls : 0;
+    uint32_t falls_b = falls < 0 ? (uint32_t)-falls : 0;
+
+    int dir = line_edges(dec, 0, 1, falls_a, level_a, now_us);
+    dir += line_edges(dec, 1, -1, falls_b, level_b, now_us);
+    dec->state = (uint8_t)((level_a ? 2 : 0) | (level_b ? 1 : 0));
+    return dir;
+}
+
+uint32_t knob_decoder_velocity(const knob_decoder_t *dec, uint32_t now_us)
+{
+    if (!dec->last_dir || (uint32_t)(now_us - dec->last_detent_us) >= KNOB_DECODER_IDLE_US)
+        return 0;
+    return dec->velocity_q4 >> 4;
+}
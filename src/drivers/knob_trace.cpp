@@ -0,0 +1,117 @@
+#include "knob_trace.h"
+#include "encoder_manager.h"
+#include "lcd_config.h"
+#include "driver/gpio.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+// Static member definitions
+KnobTrace::Sample* KnobTrace::samples = nullptr;
+volatile uint32_t KnobTrace::count = 0;
+volatile uint32_t KnobTrace::dropped = 0;
+volatile bool KnobTrace::running = false;
+uint32_t KnobTrace::startUs = 0;
+uint32_t KnobTrace::durationUs = 0;
+uint8_t KnobTrace::startA = 1;
+uint8_t KnobTrace::startB = 1;
+int KnobTrace::startSteps = 0;
+int KnobTrace::endSteps = 0;
+
+// Any edge on either line - the only writer while running
+void KnobTrace::onEdge(void* arg) {
+    uint32_t n = count;
+    if (n >= CAPACITY) {
+        dropped++;
+        return;
+    }
+    Sample& s = samples[n];
+    s.timeUs = (uint32_t)esp_timer_get_time() - startUs;
+    s.a = gpio_get_level((gpio_num_t)EXAMPLE_ENCODER_ECA_PIN);
+    s.b = gpio_get_level((gpio_num_t)EXAMPLE_ENCODER_ECB_PIN);
+    count = n + 1;
+}
+
+bool KnobTrace::start() {
+    if (running) return true;
+
+    if (!samples) {
+        samples = (Sample*)heap_caps_malloc(CAPACITY * sizeof(Sample), MALLOC_CAP_SPIRAM);
+        if (!samples) {
+            Serial.println("Trace buffer allocation failed (PSRAM)");
+            return false;
+        }
+    }
+
+    count = 0;
+    dropped = 0;
+    durationUs = 0;
+    startA = gpio_get_level((gpio_num_t)EXAMPLE_ENCODER_ECA_PIN);
+    startB = gpio_get_level((gpio_num_t)EXAMPLE_ENCODER_ECB_PIN);
+    startSteps = EncoderManager::getCount();
+    startUs = (uint32_t)esp_timer_get_time();
+
+    // The service may already be installed by another driver
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        Serial.printf("GPIO ISR service unavailable: %s\n", esp_err_to_name(err));
+        return false;
+    }
+
+    // Edge interrupts sit beside the knob backend; they don't change how it reads the pins
+    const gpio_num_t pins[2] = { (gpio_num_t)EXAMPLE_ENCODER_ECA_PIN, (gpio_num_t)EXAMPLE_ENCODER_ECB_PIN };
+    for (gpio_num_t pin : pins) {
+        gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+        gpio_isr_handler_add(pin, onEdge, nullptr);
+        gpio_intr_enable(pin);
+    }
+
+    running = true;
+    return true;
+}
+
+void KnobTrace::stop() {
+    if (!running) return;
+
+    const gpio_num_t pins[2] = { (gpio_num_t)EXAMPLE_ENCODER_ECA_PIN, (gpio_num_t)EXAMPLE_ENCODER_ECB_PIN };
+    for (gpio_num_t pin : pins) {
+        gpio_intr_disable(pin);
+        gpio_isr_handler_remove(pin);
+        gpio_set_intr_type(pin, GPIO_INTR_DISABLE);
+    }
+
+    running = false;
+    durationUs = (uint32_t)esp_timer_get_time() - startUs;
+    endSteps = EncoderManager::getCount();
+}
+
+void KnobTrace::dump() {
+    if (running) {
+        Serial.println("Stop the capture first: knob trace stop");
+        return;
+    }
+    if (!samples || count == 0) {
+        Serial.println("No trace captured");
+        return;
+    }
+
+    // Format read by tools/knob_replay.c
+    Serial.println("# knobtrace v1");
+    Serial.printf("# start a=%u b=%u\n", startA, startB);
+    Serial.printf("# duration_us=%lu edges=%lu dropped=%lu device_steps=%d\n",
+                  durationUs, (uint32_t)count, (uint32_t)dropped, endSteps - startSteps);
+    for (uint32_t i = 0; i < count; i++) {
+        Serial.printf("%lu %u %u\n", samples[i].timeUs, samples[i].a, samples[i].b);
+        if ((i & 255) == 255) delay(1);  // Let the USB CDC buffer drain
+    }
+    Serial.println("# end");
+}
+
+void KnobTrace::printStatus() {
+    Serial.println("\n=== KNOB TRACE ===");
+    Serial.printf("Capture:  %s\n", running ? "running" : "stopped");
+    Serial.printf("Edges:    %lu of %lu, %lu dropped\n", (uint32_t)count, CAPACITY, (uint32_t)dropped);
+    if (!running && durationUs) {
+        Serial.printf("Length:   %lu ms, device counted %d detents\n", durationUs / 1000, endSteps - startSteps);
+    }
+    Serial.println("==================\n");
+}
@@ -1,12 +1,30 @@
 #include "lcd_driver.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_sh8601.h"
+#include "esp_timer.h"
+#include "cst816.h"
+#include "input_frame.h"
+#include "sh8601_panel.h"
+#include "ui_scheduler.h"
+
+// Static member definitions
+esp_lcd_panel_handle_t LcdDriver::panel = nullptr;
+bool LcdDriver::touchReady = false;
+lv_disp_drv_t* volatile LcdDriver::flushingDrv = nullptr;
+SemaphoreHandle_t LcdDriver::transferDone = nullptr;
+SemaphoreHandle_t LcdDriver::flushDone = nullptr;
+int64_t LcdDriver::flushStartUs = 0;
+uint32_t LcdDriver::flushBusyUs = 0;
+portMUX_TYPE LcdDriver::flushStatsLock = portMUX_INITIALIZER_UNLOCKED;
 
 bool LcdDriver::initLcd() {
     Serial.println("Initializing LCD hardware...");
     
-    // TODO: Initialize actual LCD hardware
-    // This would include SPI setup, pin configuration, LCD controller init
     setupPins();
-    initHardware();
+    if (!initHardware()) {
+        Serial.println("SH8601 panel initialization failed");
+        return false;
+    }
     
     Serial.println("LCD hardware initialized");
     return true;
@@ -15,10 +33,18 @@ bool LcdDriver::initLcd() {
 bool LcdDriver::initTouch() {
     Serial.println("Initializing touch hardware...");
     
-    // TODO: Initialize touch controller if present
-    // For encoder-only system, this might be empty
+    // CST816 over I2C - without it the knob still works, so this never fails setup
+    touchReady = Touch_Init();
+    if (!touchReady) {
+        Serial.println("Touch controller unavailable (encoder-only)");
+        return true;
+    }
     
-    Serial.println("Touch hardware initialized (encoder-only)");
+    touch_stats_t stats;
+    Touch_GetStats(&stats);
+    Serial.printf("Touch hardware initialized (%s)\n",
+                  stats.interrupt_mode ? "interrupt driven"
+                                        : "polled on every read - interrupt mode needs EXAMPLE_PIN_NUM_TOUCH_INT");
     return true;
 }
 
@@ -29,28 +55,141 @@ void LcdDriver::setupPins() {
     digitalWrite(EXAMPLE_PIN_NUM_BK_LIGHT, HIGH); // Turn on backlight
 }
 
-void LcdDriver::initHardware() {
-    // TODO: Initialize SPI, LCD controller, etc.
-    // This is where you'd set up the actual hardware communication
+bool LcdDriver::initHardware() {
+    transferDone = xSemaphoreCreateCounting(16, 0);
+    flushDone = xSemaphoreCreateBinary();
+    if (!transferDone || !flushDone) return false;
+    
+    esp_lcd_panel_handle_t handle = nullptr;
+    esp_err_t err = sh8601_panel_create(onTransferDone, nullptr, &handle);
+    if (err != ESP_OK) {
+        Serial.printf("SH8601: %s\n", esp_err_to_name(err));
+        return false;
+    }
+    attachPanel(handle);
+    return true;
+}
+
+// SPI interrupt - a colour transfer has left its buffer
+bool LcdDriver::onTransferDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t* edata, void* ctx) {
+    lv_disp_drv_t* drv = flushingDrv;
+    if (drv) {
+        flushingDrv = nullptr;
+        portENTER_CRITICAL_ISR(&flushStatsLock);
+        flushBusyUs += (uint32_t)(esp_timer_get_time() - flushStartUs);
+        portEXIT_CRITICAL_ISR(&flushStatsLock);
+        lv_disp_flush_ready(drv);
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR(flushDone, &woken);
+        bool schedulerWoken = ui_scheduler_notify_from_isr(UI_EVENT_FLUSH_DONE);
+        return schedulerWoken || woken == pdTRUE;
+    }
+    
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(transferDone, &woken);
+    return woken == pdTRUE;
 }
 
-// Display flush callback - implement based on your hardware
+// Display flush callback - LVGL may render into its other buffer while this one is sent
 void LcdDriver::display_flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
-    // TODO: Implement actual display driver based on your hardware
-    // This is a placeholder that just marks the flush as ready
-    // You'll need to replace this with calls to your LCD driver
+    if (!panel) {
+        lv_disp_flush_ready(disp);
+        return;
+    }
     
-    // Example implementation would look like:
-    // spi_write_bitmap(area->x1, area->y1, area->x2, area->y2, color_p);
+    flushStartUs = esp_timer_get_time();
+    flushingDrv = disp;
+    if (esp_lcd_panel_draw_bitmap(panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_p) != ESP_OK) {
+        flushingDrv = nullptr;
+        lv_disp_flush_ready(disp);
+    }
+}
+
+uint32_t LcdDriver::takeFlushBusyUs() {
+    portENTER_CRITICAL(&flushStatsLock);
+    uint32_t us = flushBusyUs;
+    flushBusyUs = 0;
+    portEXIT_CRITICAL(&flushStatsLock);
+    return us;
+}
+
+// flushDone is binary, so a give left over from an earlier flush only costs
+// one extra pass round the loop
+bool LcdDriver::waitFlushDone(uint32_t timeoutMs) {
+    if (!flushDone) return flushingDrv == nullptr;
     
-    // For now, just mark as ready
-    lv_disp_flush_ready(disp);
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeoutMs * 1000;
+    while (flushingDrv) {
+        int64_t leftUs = deadline - esp_timer_get_time();
+        if (leftUs <= 0) break;
+        xSemaphoreTake(flushDone, pdMS_TO_TICKS(leftUs / 1000) + 1);
+    }
+    return flushingDrv == nullptr;
+}
+
+void LcdDriver::rounder_cb(lv_disp_drv_t *disp, lv_area_t *area) {
+    area->x1 &= ~1;
+    area->y1 &= ~1;
+    area->x2 |= 1;
+    area->y2 |= 1;
 }
 
-// Touchpad read callback - placeholder for encoder-only input
+// Touchpad read callback - in interrupt mode this only copies the cached sample
 void LcdDriver::touchpad_read_cb(lv_indev_drv_t *indev_driver, lv_indev_data_t *data) {
-    // Since we're using rotary encoder only, no touch input
-    data->state = LV_INDEV_STATE_REL;
+    uint16_t x = 0, y = 0;
+    if (touchReady && getTouch(&x, &y)) {
+#ifdef EXAMPLE_Rotate_90
+        data->point.x = y;
+        data->point.y = EXAMPLE_LCD_V_RES - x;
+#else
+        data->point.x = x;
+        data->point.y = y;
+#endif
+        if (data->point.x > EXAMPLE_LCD_H_RES) data->point.x = EXAMPLE_LCD_H_RES;
+        if (data->point.y > EXAMPLE_LCD_V_RES) data->point.y = EXAMPLE_LCD_V_RES;
+        data->state = LV_INDEV_STATE_PR;
+    } else {
+        data->state = LV_INDEV_STATE_REL;
+    }
+    
+    // Per-frame touch summary for the active app (BaseApp::onInput)
+    input_frame_touch(data->state == LV_INDEV_STATE_PR, data->point.x, data->point.y);
+}
+
+void LcdDriver::printTouchStats() {
+    Serial.println("\n=== TOUCH ===");
+    if (!touchReady) {
+        Serial.println("Touch controller not initialized");
+        Serial.println("=============\n");
+        return;
+    }
+    
+    touch_stats_t stats;
+    Touch_GetStats(&stats);
+    float seconds = (uint32_t)(esp_timer_get_time() / 1000 - stats.since_ms) / 1000.0f;
+    if (seconds <= 0) seconds = 1;
+    uint32_t avgUs = stats.reads ? (uint32_t)(stats.bus_us / stats.reads) : 0;
+    
+    Serial.printf("Mode:     %s\n", stats.interrupt_mode ? "interrupt (INT line)" : "polling");
+    Serial.printf("Polls:    %lu (%.1f/s), %lu from the cached sample\n", stats.polls, stats.polls / seconds, stats.cached);
+    Serial.printf("Reads:    %lu (%.1f/s), %lu interrupts, %lu errors\n",
+                  stats.reads, stats.reads / seconds, stats.interrupts, stats.errors);
+    Serial.printf("I2C time: %lu us avg, %lu us max, %.0f us/s on the bus\n",
+                  avgUs, stats.max_read_us, stats.bus_us / seconds);
+    Serial.printf("Gestures: %lu recognised\n", stats.gestures);
+    if (stats.interrupt_mode) {
+        // Every cached poll would have been a blocking read on the LVGL task
+        Serial.printf("Saved:    %lu reads, ~%.0f us/s of LVGL task time\n",
+                      stats.cached, (float)stats.cached * avgUs / seconds);
+    } else {
+        Serial.printf("Idle cost: every poll blocks the LVGL task ~%lu us (%.0f us/s)\n",
+                      avgUs, stats.bus_us / seconds);
+    }
+    Serial.println("=============\n");
+}
+
+void LcdDriver::resetTouchStats() {
+    if (touchReady) Touch_ResetStats();
 }
 
 void LcdDriver::setBacklight(bool on) {
@@ -67,6 +206,35 @@ void LcdDriver::powerUp() {
     setBacklight(true);
 }
 
+bool LcdDriver::enterPartialMode(int yStart, int yEnd) {
+    if (!panel) {
+        Serial.println("Partial mode unavailable - no panel attached");
+        return false;
+    }
+    return esp_lcd_sh8601_set_partial_area(panel, yStart, yEnd) == ESP_OK;
+}
+
+bool LcdDriver::exitPartialMode() {
+    if (!panel) return false;
+    return esp_lcd_sh8601_set_normal_mode(panel) == ESP_OK;
+}
+
+bool LcdDriver::setIdleMode(bool idle) {
+    if (!panel) return false;
+    return esp_lcd_sh8601_set_idle_mode(panel, idle) == ESP_OK;
+}
+
+bool LcdDriver::drawBitmap(int x1, int y1, int x2, int y2, const void* data) {
+    if (!panel) return false;
+    // Only used while LVGL is suspended, so no flush is in flight alongside
+    return esp_lcd_panel_draw_bitmap(panel, x1, y1, x2, y2, data) == ESP_OK;
+}
+
+bool LcdDriver::waitTransfer(uint32_t timeoutMs) {
+    if (!transferDone) return false;
+    return xSemaphoreTake(transferDone, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
 void LcdDriver::printHardwareInfo() {
     Serial.println("=== LCD Hardware Info ===");
     Serial.printf("Resolution: %dx%d\n", EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES);
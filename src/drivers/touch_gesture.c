@@ -0,0 +1,216 @@
+/*
+ * Touch gesture recognizer for the round panel.
+ *
+ * One pass per sample, integer only. Rotation is tracked incrementally: the
+ * binary angle of each sample around the center is subtracted from the
+ * previous one in 16 bits, which wraps across 0/360 degrees for free.
+ */
+
+#include <string.h>
+#include "touch_gesture.h"
+
+/* 65536 / (2 * pi): radians to binary angle */
+#define RAD_TO_ANGLE 10430
+
+/* Keeps the Q15 division below in 32 bits; far beyond any panel */
+#define COORD_LIMIT 4096
+
+static int32_t clamp_coord(int32_t v)
+{
+    if (v > COORD_LIMIT)
+        return COORD_LIMIT;
+    if (v < -COORD_LIMIT)
+        return -COORD_LIMIT;
+    return v;
+}
+
+// atan(small / big) for 0 <= small <= big, 0..8192 (45 degrees).
+// atan(z) ~ z / (1 + 0.28125 z^2) with z in Q15
+static int32_t octant_angle(int32_t big, int32_t small)
+{
+    int32_t z = (small << 15) / big;
+    int32_t z2 = (z * z) >> 15;
+    return (z * RAD_TO_ANGLE) / (32768 + ((z2 * 9) >> 5));
+}
+
+uint16_t touch_gesture_angle(int32_t x, int32_t y)
+{
+    x = clamp_coord(x);
+    y = clamp_coord(y);
+    if (x == 0 && y == 0)
+        return 0;
+
+    int32_t ax = x < 0 ? -x : x;
+    int32_t ay = y < 0 ? -y : y;
+    int32_t a = ay <= ax ? octant_angle(ax, ay) : 16384 - octant_angle(ay, ax);
+    if (x < 0)
+        a = 32768 - a;
+    if (y < 0)
+        a = 65536 - a;
+    return (uint16_t)a;
+}
+
+static uint32_t dist2(int32_t dx, int32_t dy)
+{
+    dx = clamp_coord(dx);
+    dy = clamp_coord(dy);
+    return (uint32_t)(dx * dx + dy * dy);
+}
+
+static uint32_t sq(uint32_t v)
+{
+    return v * v;
+}
+
+static bool on_ring(const touch_gesture_t *g, int16_t x, int16_t y)
+{
+    return dist2(x - g->cfg.center_x, y - g->cfg.center_y) >= sq(g->cfg.ring_inner);
+}
+
+static touch_gesture_event_t *emit(touch_gesture_t *g, touch_gesture_event_t *out, int *n,
+                                   touch_gesture_type_t type)
+{
+    touch_gesture_event_t *ev = &out[(*n)++];
+    memset(ev, 0, sizeof(*ev));
+    ev->type = type;
+    ev->x = g->start_x;
+    ev->y = g->start_y;
+    g->events++;
+    return ev;
+}
+
+void touch_gesture_init(touch_gesture_t *g, const touch_gesture_config_t *cfg)
+{
+    static const touch_gesture_config_t defaults = TOUCH_GESTURE_CONFIG_DEFAULT;
+
+    memset(g, 0, sizeof(*g));
+    g->cfg = cfg ? *cfg : defaults;
+    if (g->cfg.rotate_step == 0)
+        g->cfg.rotate_step = defaults.rotate_step;
+}
+
+static void touch_down(touch_gesture_t *g, int16_t x, int16_t y, uint32_t now_us)
+{
+    g->down = true;
+    g->moved = false;
+    g->long_fired = false;
+    g->rotating = false;
+    g->start_x = g->last_x = x;
+    g->start_y = g->last_y = y;
+    g->down_us = now_us;
+    g->in_ring = on_ring(g, x, y);
+    g->last_angle = touch_gesture_angle(x - g->cfg.center_x, y - g->cfg.center_y);
+    g->swept = 0;
+    g->step_residue = 0;
+}
+
+// Follow the finger around the center; rotation starts once enough angle is swept on the ring
+static void track_rotation(touch_gesture_t *g, int16_t x, int16_t y, touch_gesture_event_t *out, int *n)
+{
+    if (!g->in_ring)
+        return;
+    if (!g->rotating && !on_ring(g, x, y))
+    {
+        // Cut through the middle: a swipe or a drag, not a turn
+        g->in_ring = false;
+        return;
+    }
+
+    uint16_t a = touch_gesture_angle(x - g->cfg.center_x, y - g->cfg.center_y);
+    int32_t d = (int16_t)(uint16_t)(a - g->last_angle);
+    g->last_angle = a;
+    g->swept += d;
+
+    if (!g->rotating)
+    {
+        int32_t swept = g->swept < 0 ? -g->swept : g->swept;
+        if (swept < g->cfg.rotate_start || g->long_fired)
+            return;
+        g->rotating = true;
+        d = g->swept; // Report the whole lead-in with the first event
+    }
+    if (d == 0)
+        return;
+
+    g->step_residue += d;
+    int32_t steps = g->step_residue / (int32_t)g->cfg.rotate_step;
+    g->step_residue -= steps * (int32_t)g->cfg.rotate_step;
+
+    touch_gesture_event_t *ev = emit(g, out, n, TOUCH_GESTURE_ROTATE);
+    ev->angle = (int16_t)d;
+    ev->steps = (int8_t)steps;
+}
+
+static void touch_up(touch_gesture_t *g, uint32_t now_us, touch_gesture_event_t *out, int *n)
+{
+    g->down = false;
+    if (g->rotating || g->long_fired)
+        return;
+
+    if (!g->moved)
+    {
+        bool twice = g->tap_pending && (uint32_t)(g->down_us - g->tap_up_us) <= g->cfg.double_tap_us &&
+                     dist2(g->start_x - g->tap_x, g->start_y - g->tap_y) <= sq(g->cfg.double_tap_slop);
+        if (twice)
+        {
+            // A third tap starts a new pair rather than doubling again
+            g->tap_pending = false;
+            emit(g, out, n, TOUCH_GESTURE_DOUBLE_TAP);
+            return;
+        }
+        g->tap_pending = true;
+        g->tap_up_us = now_us;
+        g->tap_x = g->start_x;
+        g->tap_y = g->start_y;
+        emit(g, out, n, TOUCH_GESTURE_TAP);
+        return;
+    }
+
+    int32_t dx = g->last_x - g->start_x;
+    int32_t dy = g->last_y - g->start_y;
+    if (dist2(dx, dy) < sq(g->cfg.swipe_min) || (uint32_t)(now_us - g->down_us) > g->cfg.swipe_max_us)
+        return;
+
+    int32_t adx = dx < 0 ? -dx : dx;
+    int32_t ady = dy < 0 ? -dy : dy;
+    touch_gesture_event_t *ev = emit(g, out, n, TOUCH_GESTURE_SWIPE);
+    if (adx >= ady)
+        ev->swipe = dx < 0 ? TOUCH_SWIPE_LEFT : TOUCH_SWIPE_RIGHT;
+    else
+        ev->swipe = dy < 0 ? TOUCH_SWIPE_UP : TOUCH_SWIPE_DOWN;
+}
+
+int touch_gesture_feed(touch_gesture_t *g, bool pressed, int16_t x, int16_t y, uint32_t now_us,
+                       touch_gesture_event_t *out)
+{
+    int n = 0;
+    g->samples++;
+
+    if (!pressed)
+    {
+        if (g->down)
+            touch_up(g, now_us, out, &n);
+        return n;
+    }
+    if (!g->down)
+    {
+        touch_down(g, x, y, now_us);
+        return 0;
+    }
+
+    if (!g->moved && dist2(x - g->start_x, y - g->start_y) > sq(g->cfg.slop))
+        g->moved = true;
+
+    track_rotation(g, x, y, out, &n);
+
+    if (!g->moved && !g->long_fired && !g->rotating && (uint32_t)(now_us - g->down_us) >= g->cfg.long_press_us)
+    {
+        g->long_fired = true;
+        g->tap_pending = false;
+        emit(g, out, &n, TOUCH_GESTURE_LONG_PRESS);
+    }
+
+    g->last_x = x;
+    g->last_y = y;
+    return n;
+}
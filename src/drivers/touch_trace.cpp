@@ -0,0 +1,94 @@
+#include "touch_trace.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+// Static member definitions
+TouchTrace::Sample* TouchTrace::samples = nullptr;
+volatile uint32_t TouchTrace::count = 0;
+volatile uint32_t TouchTrace::dropped = 0;
+volatile bool TouchTrace::running = false;
+bool TouchTrace::lastPressed = false;
+uint32_t TouchTrace::startUs = 0;
+uint32_t TouchTrace::durationUs = 0;
+
+// Touch task (interrupt mode) or UI task (polling) - the only writer while running
+void TouchTrace::record(bool pressed, int16_t x, int16_t y) {
+    if (!running) return;
+    // Polling reports "released" on every read; the first one is all the replay needs
+    if (!pressed && !lastPressed) return;
+    lastPressed = pressed;
+
+    uint32_t n = count;
+    if (n >= CAPACITY) {
+        dropped++;
+        return;
+    }
+    Sample& s = samples[n];
+    s.timeUs = (uint32_t)esp_timer_get_time() - startUs;
+    s.x = x;
+    s.y = y;
+    s.pressed = pressed ? 1 : 0;
+    count = n + 1;
+}
+
+bool TouchTrace::start() {
+    if (running) return true;
+
+    if (!samples) {
+        samples = (Sample*)heap_caps_malloc(CAPACITY * sizeof(Sample), MALLOC_CAP_SPIRAM);
+        if (!samples) {
+            Serial.println("Trace buffer allocation failed (PSRAM)");
+            return false;
+        }
+    }
+
+    count = 0;
+    dropped = 0;
+    durationUs = 0;
+    lastPressed = false;
+    startUs = (uint32_t)esp_timer_get_time();
+    running = true;
+    return true;
+}
+
+void TouchTrace::stop() {
+    if (!running) return;
+    running = false;
+    durationUs = (uint32_t)esp_timer_get_time() - startUs;
+}
+
+void TouchTrace::dump() {
+    if (running) {
+        Serial.println("Stop the capture first: touch trace stop");
+        return;
+    }
+    if (!samples || count == 0) {
+        Serial.println("No trace captured");
+        return;
+    }
+
+    // Format read by tools/touch_replay.c
+    Serial.println("# touchtrace v1");
+    Serial.printf("# duration_us=%lu samples=%lu dropped=%lu\n", durationUs, (uint32_t)count, (uint32_t)dropped);
+    Serial.println("# Add what you did, e.g. \"# expect swipe left\", then replay");
+    for (uint32_t i = 0; i < count; i++) {
+        Serial.printf("%lu %u %d %d\n", samples[i].timeUs, samples[i].pressed, samples[i].x, samples[i].y);
+        if ((i & 255) == 255) delay(1);  // Let the USB CDC buffer drain
+    }
+    Serial.println("# end");
+}
+
+void TouchTrace::printStatus() {
+    Serial.println("\n=== TOUCH TRACE ===");
+    Serial.printf("Capture:  %s\n", running ? "running" : "stopped");
+    Serial.printf("Samples:  %lu of %lu, %lu dropped\n", (uint32_t)count, CAPACITY, (uint32_t)dropped);
+    if (!running && durationUs) {
+        Serial.printf("Length:   %lu ms\n", durationUs / 1000);
+    }
+    Serial.println("===================\n");
+}
+
+// C entry point
+extern "C" void touch_trace_record(bool pressed, int16_t x, int16_t y) {
+    TouchTrace::record(pressed, x, y);
+}
@@ -344,3 +344,40 @@ static esp_err_t panel_sh8601_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     ESP_RETURN_ON_ERROR(tx_param(sh8601, io, command, NULL, 0), TAG, "send command failed");
     return ESP_OK;
 }
+
+esp_err_t esp_lcd_sh8601_set_partial_area(esp_lcd_panel_handle_t panel, int y_start, int y_end)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(y_start <= y_end, ESP_ERR_INVALID_ARG, TAG, "start row must not be after end row");
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    esp_lcd_panel_io_handle_t io = sh8601->io;
+
+    y_start += sh8601->y_gap;
+    y_end += sh8601->y_gap;
+
+    ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_PTLAR, (uint8_t[]) {
+        (y_start >> 8) & 0xFF,
+        y_start & 0xFF,
+        (y_end >> 8) & 0xFF,
+        y_end & 0xFF,
+    }, 4), TAG, "send command failed");
+    ESP_RETURN_ON_ERROR(tx_param(sh8601, io, LCD_CMD_PTLON, NULL, 0), TAG, "send command failed");
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_sh8601_set_normal_mode(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    ESP_RETURN_ON_ERROR(tx_param(sh8601, sh8601->io, LCD_CMD_NORON, NULL, 0), TAG, "send command failed");
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_sh8601_set_idle_mode(esp_lcd_panel_handle_t panel, bool idle)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    sh8601_panel_t *sh8601 = __containerof(panel, sh8601_panel_t, base);
+    int command = idle ? LCD_CMD_IDMON : LCD_CMD_IDMOFF;
+    ESP_RETURN_ON_ERROR(tx_param(sh8601, sh8601->io, command, NULL, 0), TAG, "send command failed");
+    return ESP_OK;
+}
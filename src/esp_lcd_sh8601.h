@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "esp_lcd_panel_vendor.h"
 
@@ -55,6 +56,41 @@ typedef struct {
  */
 esp_err_t esp_lcd_new_panel_sh8601(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config, esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Restrict the panel to a partial display area
+ *
+ * @note  Rows outside [y_start, y_end] are blanked by the panel and no longer scanned from frame memory.
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_sh8601()`
+ * @param[in] y_start First row of the partial area
+ * @param[in] y_end Last row of the partial area (inclusive)
+ * @return
+ *      - ESP_OK: Success
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_sh8601_set_partial_area(esp_lcd_panel_handle_t panel, int y_start, int y_end);
+
+/**
+ * @brief Leave partial display mode and return to normal full-screen display
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_sh8601()`
+ * @return
+ *      - ESP_OK: Success
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_sh8601_set_normal_mode(esp_lcd_panel_handle_t panel);
+
+/**
+ * @brief Enter or leave idle mode (reduced 8-colour display)
+ *
+ * @param[in] panel LCD panel handle returned by `esp_lcd_new_panel_sh8601()`
+ * @param[in] idle true to enter idle mode, false to leave it
+ * @return
+ *      - ESP_OK: Success
+ *      - Otherwise: Fail
+ */
+esp_err_t esp_lcd_sh8601_set_idle_mode(esp_lcd_panel_handle_t panel, bool idle);
+
 /**
  * @brief LCD panel bus configuration structure
  *
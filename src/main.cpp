@@ -9,6 +9,14 @@
 
 #include "encoder_manager.h"/
 #include "app_manager.h"
+#include "ui_scheduler.h"
+#include "serial_command_handler.h"
+#include "perf_overlay.h"
+#include "app_registry.h"
+#include "layout_loader.h"
+#include "ui_styles.h"
+#include "widget_pool.h"
+#include "knob_input.h"
 
 // Include all the apps
 #include "home_app.h"
@@ -24,16 +32,9 @@
 
 Preferences preferences;
 
-// Global app instances - these will register themselves
-HomeApp homeApp;
-EnergyApp energyApp;
-WeatherApp weatherApp;
-HouseApp houseApp;
-ClockApp clockApp;
-SettingsApp settingsApp;
-
-// Function declarations
-void onMQTTMessage(const char* topic, const char* payload);
+// Compile-time app list - ring order and storage are fixed here
+typedef AppRegistry<HomeApp, EnergyApp, WeatherApp, HouseApp, ClockApp, SettingsApp> Apps;
+static_assert(Apps::COUNT <= AppManager::MAX_APPS, "Too many apps for AppManager");
 
 void setup() {
     Serial.begin(115200);
@@ -65,46 +66,69 @@ void setup() {
     // Initialize WiFi
     wifiManager.begin();
     
-    // Initialize MQTT
+    // Initialize MQTT - its own task owns the client, sleeps until the socket or
+    // a queued publish needs it, and wakes the UI on inbound data
     mqttManager.begin();
     
-    // Initialize each app - they will register themselves during init()
-    Serial.println("Initializing apps...");
+    // Data topics feed the apps' widgets through UiUpdateQueue - the callbacks
+    // run on the MQTT task and never touch LVGL, so set them before it starts
+    mqttManager.setEnergyCallback([](const JsonDocument& doc, const String&) {
+        Apps::get<EnergyApp>().onEnergyData(doc);
+    });
+    mqttManager.setWeatherCallback([](const JsonDocument& doc, const String&) {
+        Apps::get<WeatherApp>().onWeatherData(doc);
+    });
+    mqttManager.setHouseCallback([](const JsonDocument& doc, const String&) {
+        Apps::get<HouseApp>().onHouseData(doc);
+    });
+    mqttManager.startLoopTask();
+    
+    // Shared styles and recyclable widgets used by every app screen
+    UiStyles::begin();
+    WidgetPool::begin();
+    
+    // Screen layouts from SPIFFS - apps fall back to built-in screens without them
+    LayoutLoader::begin();
+    
+    // Register apps in ring order - screens are built lazily on first visit
+    Serial.println("Registering apps...");
+    
+    appManager.registerApps(Apps::table(), Apps::COUNT);
+    appManager.begin();
+    if (!appManager.startBackgroundTask()) {
+        Serial.println("Failed to start app background task");
+    }
+    
+    // Per-app LVGL memory goes out with the MQTT device status
+    mqttManager.setStatusCallback([](JsonDocument& doc) {
+        appManager.addMemoryStatus(doc);
+    });
     
-    homeApp.init();
-    energyApp.init();
-    weatherApp.init();
-    houseApp.init();
-    clockApp.init();
-    settingsApp.init();
+    Serial.printf("Registered %d apps\n", appManager.getAppCount());
     
-    Serial.printf("Initialized and registered %d apps\n", appManager.getAppCount());
-  /** 
-    // Initialize encoder with simple callback to AppManager
+    // Detents are batched on the encoder task and routed by KnobInput: to
+    // AppManager for app switching, or to the active app's LVGL group
     if (!EncoderManager::begin()) {
         Serial.println("Failed to initialize encoder");
-        return;
     }
-  
-    // Set up simple encoder callback - encoder just calls AppManager
-    EncoderManager::setChangeCallback([](int direction) {
-        appManager.onEncoderChange(direction);
-    });   
-    */
+    if (!KnobInput::begin()) {
+        Serial.println("Failed to register knob input device");
+    }
+    
+    // Restore the performance overlay if it was left enabled
+    PerfOverlay::begin();
+    
+    SerialCommandHandler::begin();
+    UiScheduler::begin();
+    
     Serial.println("System initialization complete");
 }
 
 void loop() {
-    // Handle system updates
-    // WiFiManager doesn't need update/loop method
-    /*
-    mqttManager.loop();
-    DisplayManager::handleLVGLTasks();
-    
-    // Update current app
-    appManager.update();
-    
-    // Small delay to prevent watchdog issues
-    vTaskDelay(pdMS_TO_TICKS(10));*/
-  
+    // WiFiManager doesn't need update/loop method; MQTT runs on its own task
+    SerialCommandHandler::handleSerialInput();
+    
+    // Runs LVGL and the current app, then sleeps until input, MQTT data,
+    // a flush completing, serial input or the next LVGL timer deadline
+    UiScheduler::runOnce();
 }
@@ -0,0 +1,282 @@
+#include "always_on_display.h"
+#include "display_manager.h"
+#include "ui_scheduler.h"
+#include "esp_heap_caps.h"
+#include <time.h>
+
+// Static member definitions
+bool AlwaysOnDisplay::active = false;
+uint8_t* AlwaysOnDisplay::bitmap = nullptr;
+uint8_t* AlwaysOnDisplay::lastBitmap = nullptr;
+uint16_t* AlwaysOnDisplay::lineBuf[2] = { nullptr, nullptr };
+esp_timer_handle_t AlwaysOnDisplay::timer = nullptr;
+volatile bool AlwaysOnDisplay::updateDue = false;
+size_t AlwaysOnDisplay::bytesReleased = 0;
+size_t AlwaysOnDisplay::bytesAllocated = 0;
+size_t AlwaysOnDisplay::heapBefore = 0;
+size_t AlwaysOnDisplay::heapActive = 0;
+uint32_t AlwaysOnDisplay::busBytes = 0;
+uint32_t AlwaysOnDisplay::updates = 0;
+uint32_t AlwaysOnDisplay::lastUpdateUs = 0;
+uint32_t AlwaysOnDisplay::maxUpdateUs = 0;
+unsigned long AlwaysOnDisplay::enteredAt = 0;
+
+// Seven-segment digit layout (bits a..g) - index 10 is a dash for unknown time
+static const uint8_t DIGIT_SEGMENTS[] = { 0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F, 0x40 };
+static const int DIGIT_W = 40;
+static const int DIGIT_H = 56;
+static const int SEG_T = 6;
+static const int DIGIT_GAP = 8;
+static const int COLON_W = 12;
+
+bool AlwaysOnDisplay::enter() {
+    if (active) return true;
+
+    if (!LcdDriver::hasPanel()) {
+        Serial.println("Always-on mode unavailable - no panel attached");
+        return false;
+    }
+
+    // Stop LVGL first so its draw buffers can be handed back before we allocate ours
+    heapBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    bytesReleased = DisplayManager::suspendRendering();
+    if (!DisplayManager::isRenderingSuspended()) {
+        Serial.println("Always-on mode unavailable - LVGL still owns the panel");
+        return false;
+    }
+    if (!allocBuffers()) {
+        Serial.println("Failed to allocate always-on buffers");
+        DisplayManager::resumeRendering();
+        return false;
+    }
+    heapActive = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+
+    LcdDriver::enterPartialMode(REGION_Y, REGION_Y + REGION_HEIGHT - 1);
+    LcdDriver::setIdleMode(true);
+    busBytes = 2 * CMD_OVERHEAD_BYTES;
+    updates = 0;
+    maxUpdateUs = 0;
+    enteredAt = millis();
+    updateDue = false;
+    active = true;
+
+    // Frame memory still holds the LVGL frame - repaint the whole region once
+    renderTime();
+    flushRegion(true);
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onTimer;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "aod_clock";
+    esp_timer_create(&timerArgs, &timer);
+    scheduleNextUpdate();
+
+    Serial.printf("Always-on mode active: free internal heap %u -> %u bytes (%+d)\n",
+                  heapBefore, heapActive, (int)heapActive - (int)heapBefore);
+    return true;
+}
+
+void AlwaysOnDisplay::exit() {
+    if (!active) return;
+
+    // The timer callback only raises updateDue, and updates run on this task -
+    // nothing can still be drawing from the buffers freed below
+    if (timer) {
+        esp_timer_stop(timer);
+        esp_timer_delete(timer);
+        timer = nullptr;
+    }
+    updateDue = false;
+
+    LcdDriver::setIdleMode(false);
+    LcdDriver::exitPartialMode();
+    active = false;
+
+    printStats();
+    freeBuffers();
+    DisplayManager::resumeRendering();
+}
+
+void AlwaysOnDisplay::printStats() {
+    Serial.println("\n=== ALWAYS-ON DISPLAY ===");
+    Serial.printf("Active: %s\n", active ? "Yes" : "No");
+    Serial.printf("RAM released: %u bytes, allocated: %u bytes\n", bytesReleased, bytesAllocated);
+    if (heapBefore) {
+        Serial.printf("Free internal heap (measured): %u before, %u while active (%+d)\n",
+                      heapBefore, heapActive, (int)heapActive - (int)heapBefore);
+    }
+
+    float minutes = (millis() - enteredAt) / 60000.0f;
+    if (minutes < 1.0f) minutes = 1.0f;
+    Serial.printf("Updates: %lu, bus bytes: %lu (%.0f bytes/min)\n", updates, busBytes, busBytes / minutes);
+    Serial.printf("Update time: %lu us last, %lu us max (render + DMA)\n", lastUpdateUs, maxUpdateUs);
+    Serial.printf("Full-frame equivalent: %u bytes/frame\n",
+                  EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES * (LCD_BIT_PER_PIXEL / 8));
+    Serial.println("=========================\n");
+}
+
+bool AlwaysOnDisplay::allocBuffers() {
+    const size_t lineBytes = REGION_WIDTH * CHUNK_ROWS * sizeof(uint16_t);
+
+    bitmap = (uint8_t*)heap_caps_calloc(1, BITMAP_BYTES, MALLOC_CAP_INTERNAL);
+    lastBitmap = (uint8_t*)heap_caps_calloc(1, BITMAP_BYTES, MALLOC_CAP_INTERNAL);
+    lineBuf[0] = (uint16_t*)heap_caps_malloc(lineBytes, MALLOC_CAP_DMA);
+    lineBuf[1] = (uint16_t*)heap_caps_malloc(lineBytes, MALLOC_CAP_DMA);
+    if (!bitmap || !lastBitmap || !lineBuf[0] || !lineBuf[1]) {
+        freeBuffers();
+        return false;
+    }
+
+    bytesAllocated = 2 * BITMAP_BYTES + 2 * lineBytes;
+    return true;
+}
+
+void AlwaysOnDisplay::freeBuffers() {
+    heap_caps_free(bitmap);
+    heap_caps_free(lastBitmap);
+    heap_caps_free(lineBuf[0]);
+    heap_caps_free(lineBuf[1]);
+    bitmap = nullptr;
+    lastBitmap = nullptr;
+    lineBuf[0] = nullptr;
+    lineBuf[1] = nullptr;
+}
+
+void AlwaysOnDisplay::renderTime() {
+    time_t now = time(nullptr);
+    struct tm t;
+    localtime_r(&now, &t);
+    bool timeValid = t.tm_year >= (2020 - 1900);
+
+    uint8_t digits[4];
+    if (timeValid) {
+        digits[0] = t.tm_hour / 10;
+        digits[1] = t.tm_hour % 10;
+        digits[2] = t.tm_min / 10;
+        digits[3] = t.tm_min % 10;
+    } else {
+        digits[0] = digits[1] = digits[2] = digits[3] = 10;
+    }
+
+    memset(bitmap, 0, BITMAP_BYTES);
+
+    const int totalW = 4 * DIGIT_W + 2 * DIGIT_GAP + COLON_W + 2 * DIGIT_GAP;
+    const int y = (REGION_HEIGHT - DIGIT_H) / 2;
+    int x = (REGION_WIDTH - totalW) / 2;
+
+    drawDigit(x, y, DIGIT_SEGMENTS[digits[0]]);
+    x += DIGIT_W + DIGIT_GAP;
+    drawDigit(x, y, DIGIT_SEGMENTS[digits[1]]);
+    x += DIGIT_W + DIGIT_GAP;
+    fillRect(x + (COLON_W - SEG_T) / 2, y + DIGIT_H / 3 - SEG_T / 2, SEG_T, SEG_T);
+    fillRect(x + (COLON_W - SEG_T) / 2, y + 2 * DIGIT_H / 3 - SEG_T / 2, SEG_T, SEG_T);
+    x += COLON_W + DIGIT_GAP;
+    drawDigit(x, y, DIGIT_SEGMENTS[digits[2]]);
+    x += DIGIT_W + DIGIT_GAP;
+    drawDigit(x, y, DIGIT_SEGMENTS[digits[3]]);
+}
+
+void AlwaysOnDisplay::drawDigit(int x, int y, uint8_t segments) {
+    const int half = DIGIT_H / 2;
+    if (segments & 0x01) fillRect(x + SEG_T, y, DIGIT_W - 2 * SEG_T, SEG_T);                       // a
+    if (segments & 0x02) fillRect(x + DIGIT_W - SEG_T, y + SEG_T, SEG_T, half - SEG_T);             // b
+    if (segments & 0x04) fillRect(x + DIGIT_W - SEG_T, y + half, SEG_T, half - SEG_T);              // c
+    if (segments & 0x08) fillRect(x + SEG_T, y + DIGIT_H - SEG_T, DIGIT_W - 2 * SEG_T, SEG_T);      // d
+    if (segments & 0x10) fillRect(x, y + half, SEG_T, half - SEG_T);                                // e
+    if (segments & 0x20) fillRect(x, y + SEG_T, SEG_T, half - SEG_T);                               // f
+    if (segments & 0x40) fillRect(x + SEG_T, y + half - SEG_T / 2, DIGIT_W - 2 * SEG_T, SEG_T);     // g
+}
+
+void AlwaysOnDisplay::fillRect(int x, int y, int w, int h) {
+    for (int row = y; row < y + h; row++) {
+        uint8_t* line = bitmap + row * BITMAP_STRIDE;
+        for (int col = x; col < x + w; col++) {
+            line[col >> 3] |= 0x80 >> (col & 7);
+        }
+    }
+}
+
+void AlwaysOnDisplay::flushRegion(bool full) {
+    // Only send the byte columns that changed since the last update
+    int firstByte = 0;
+    int lastByte = BITMAP_STRIDE - 1;
+    if (!full) {
+        firstByte = BITMAP_STRIDE;
+        lastByte = -1;
+        for (int row = 0; row < REGION_HEIGHT; row++) {
+            const uint8_t* cur = bitmap + row * BITMAP_STRIDE;
+            const uint8_t* prev = lastBitmap + row * BITMAP_STRIDE;
+            for (int b = 0; b < BITMAP_STRIDE; b++) {
+                if (cur[b] != prev[b]) {
+                    if (b < firstByte) firstByte = b;
+                    if (b > lastByte) lastByte = b;
+                }
+            }
+        }
+        if (lastByte < 0) return;
+    }
+
+    const int x1 = firstByte * 8;
+    const int x2 = (lastByte + 1) * 8;
+    const int width = x2 - x1;
+    int bufIndex = 0;
+    int inFlight = 0;
+
+    for (int row = 0; row < REGION_HEIGHT; row += CHUNK_ROWS) {
+        // draw_bitmap only queues the DMA. Transfers finish in order, so with
+        // both buffers queued the oldest one is the buffer about to be refilled
+        if (inFlight == 2) {
+            LcdDriver::waitTransfer(TRANSFER_TIMEOUT_MS);
+            inFlight--;
+        }
+        uint16_t* out = lineBuf[bufIndex];
+        for (int r = 0; r < CHUNK_ROWS; r++) {
+            const uint8_t* src = bitmap + (row + r) * BITMAP_STRIDE;
+            for (int col = x1; col < x2; col++) {
+                *out++ = (src[col >> 3] & (0x80 >> (col & 7))) ? FG_COLOR : BG_COLOR;
+            }
+        }
+
+        if (LcdDriver::drawBitmap(x1, REGION_Y + row, x2, REGION_Y + row + CHUNK_ROWS, lineBuf[bufIndex])) {
+            inFlight++;
+            busBytes += width * CHUNK_ROWS * sizeof(uint16_t) + CMD_OVERHEAD_BYTES;
+        }
+        bufIndex ^= 1;
+    }
+
+    // Leave nothing in flight - exit() frees the buffers
+    while (inFlight > 0) {
+        LcdDriver::waitTransfer(TRANSFER_TIMEOUT_MS);
+        inFlight--;
+    }
+
+    memcpy(lastBitmap, bitmap, BITMAP_BYTES);
+    updates++;
+}
+
+void AlwaysOnDisplay::scheduleNextUpdate() {
+    // Wake once per minute, just after the minute changes
+    time_t now = time(nullptr);
+    struct tm t;
+    localtime_r(&now, &t);
+    uint64_t delaySec = 60 - t.tm_sec;
+    esp_timer_start_once(timer, delaySec * 1000000ULL);
+}
+
+// esp_timer task - hand the update to the UI task
+void AlwaysOnDisplay::onTimer(void* arg) {
+    updateDue = true;
+    UiScheduler::notify(UI_EVENT_REQUEST);
+}
+
+void AlwaysOnDisplay::service() {
+    if (!active || !updateDue) return;
+    updateDue = false;
+
+    int64_t start = esp_timer_get_time();
+    renderTime();
+    flushRegion(false);
+    lastUpdateUs = (uint32_t)(esp_timer_get_time() - start);
+    if (lastUpdateUs > maxUpdateUs) maxUpdateUs = lastUpdateUs;
+    scheduleNextUpdate();
+}
@@ -1,4 +1,8 @@
 #include "app_manager.h"
+#include "screen_residency.h"
+#include "widget_pool.h"
+#include "esp_timer.h"
+#include <Preferences.h>
 
 // Global app manager instance
 AppManager appManager;
@@ -9,66 +13,562 @@ AppManager::AppManager() {
 
 void AppManager::registerApp(BaseApp* app) {
     if (!app) return;
-    
-    AppNode* newNode = new AppNode(app);
-    
-    if (!currentNode) {
-        // First app - create circular list with one node
-        currentNode = newNode;
-        newNode->next = newNode; // Point to itself
-        
-        // Initialize the first app
-        switchToCurrentApp();
-    } else {
-        // Insert new node into circular list
-        newNode->next = currentNode->next;
-        currentNode->next = newNode;
+
+    for (int i = 0; i < appCount; i++) {
+        if (apps[i] == app) return;  // Already registered
     }
-    
-    appCount++;
+
+    if (appCount >= MAX_APPS) {
+        Serial.printf("Cannot register app '%s': limit of %d apps reached\n", app->getName(), MAX_APPS);
+        return;
+    }
+
+    apps[appCount++] = app;
+    loadMemoryLimits(appCount - 1);
+    publishMemorySnapshot();
     Serial.printf("App '%s' registered. Total apps: %d\n", app->getName(), appCount);
 }
 
+void AppManager::registerApps(BaseApp* const* table, int count) {
+    for (int i = 0; i < count; i++) {
+        registerApp(table[i]);
+    }
+}
+
+void AppManager::begin() {
+    if (appCount == 0 || currentIndex >= 0) return;
+
+    currentIndex = 0;
+    switchToCurrentApp();
+}
+
 void AppManager::onEncoderChange(int direction) {
-    if (!currentNode) return;
-    
-    // Deinit current app
-    if (currentNode->app) {
-        currentNode->app->deinit();
-    }
-    
-    // Move in circular list
-    if (direction > 0) {
-        // Forward - next app
-        currentNode = currentNode->next;
-    } else if (direction < 0) {
-        // Backward - find previous app by traversing circle
-        AppNode* prev = currentNode;
-        while (prev->next != currentNode) {
-            prev = prev->next;
-        }
-        currentNode = prev;
+    if (currentIndex < 0 || direction == 0) return;
+
+    // Only record the detent - the UI task switches at once if it opens a
+    // burst, otherwise when the knob settles
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&navLock);
+    if (now - lastNavUs >= (int64_t)navWindowMs * 1000) {
+        navLeading = true;
+        navBursts++;
+    }
+    pendingDelta += direction;
+    lastNavUs = now;
+    navDetents += abs(direction);   // The encoder delivers batches
+    navPending = true;
+    portEXIT_CRITICAL(&navLock);
+}
+
+void AppManager::dispatchInput() {
+    InputSnapshot input;
+    if (!InputFrame::take(input)) return;
+
+    // Only a shown app gets input; anything else is dropped with the frame
+    BaseApp* app = getCurrentApp();
+    if (app && app->getState() == BaseApp::State::Active) {
+        app->onInput(input);
     }
-    
+}
+
+void AppManager::switchBy(int delta) {
+    if (currentIndex < 0) return;
+
+    int target = wrapIndex(currentIndex + delta);
+    if (target == currentIndex) return;
+
+    // Suspend the current app - its screen stays resident
+    apps[currentIndex]->suspend();
+
+    currentIndex = target;
+
     // Switch to new current app
     switchToCurrentApp();
 }
 
-void AppManager::update() {
-    // Just update the current app
-    if (currentNode && currentNode->app) {
-        currentNode->app->update();
+uint32_t AppManager::update() {
+    uint32_t dueMs = serviceNavigation();
+
+    // Only the active app gets view updates, and only at its declared period
+    BaseApp* app = getCurrentApp();
+    if (!app) return dueMs;
+
+    BaseApp::Schedule schedule = app->getSchedule();
+    if (schedule.foregroundPeriodMs == 0) return dueMs;
+
+    int64_t now = esp_timer_get_time();
+    if (now >= nextForegroundUs) {
+        app->update();
+        int64_t done = esp_timer_get_time();
+        recordRun(foregroundStats[currentIndex], (uint32_t)(done - now), schedule.budgetUs);
+        nextForegroundUs = now + (int64_t)schedule.foregroundPeriodMs * 1000;
+        now = done;
     }
+
+    uint32_t updateMs = nextForegroundUs > now ? (uint32_t)((nextForegroundUs - now) / 1000) : 0;
+    if (dueMs < updateMs) updateMs = dueMs;
+
+    uint32_t prefetchMs = servicePrefetch();
+    return prefetchMs < updateMs ? prefetchMs : updateMs;
+}
+
+uint32_t AppManager::servicePrefetch() {
+    if (!prefetchEnabled || navPending || currentIndex < 0 || appCount < 2) return UINT32_MAX;
+
+    // Wait for the UI to go quiet after a switch so prefetching never delays the new screen
+    int64_t idleAt = lastSwitchUs + (int64_t)PREFETCH_IDLE_MS * 1000;
+    int64_t now = esp_timer_get_time();
+    if (now < idleAt) return (uint32_t)((idleAt - now + 999) / 1000);
+
+    // At most one screen per pass; come straight back for the other neighbour
+    int next = wrapIndex(currentIndex + 1);
+    int prev = wrapIndex(currentIndex - 1);
+    if (prefetchApp(next, prev) || prefetchApp(prev, next)) return 0;
+    return UINT32_MAX;
+}
+
+bool AppManager::prefetchApp(int index, int otherNeighbour) {
+    if (index == currentIndex || apps[index]->isInitialized()) return false;
+
+    // Skip screens already known not to fit
+    size_t knownBytes = memStats[index].lvglBytes;
+    if (knownBytes && prefetchedBytes + knownBytes > prefetchBudget) return false;
+
+    // Never evict the other neighbour to make room - that would just thrash
+    if (!trimResident(residentBudget - 1, index, otherNeighbour)) return false;
+
+    if (!buildScreen(index)) return false;
+
+    // Resolve layout now so the first frame after the switch only has to draw
+    lv_obj_update_layout(apps[index]->getScreen());
+
+    size_t bytes = memStats[index].lvglBytes;
+
+    if (prefetchedBytes + bytes > prefetchBudget) {
+        apps[index]->evict();
+        publishMemorySnapshot();
+        return false;
+    }
+
+    prefetched[index] = true;
+    prefetchedBytes += bytes;
+    if (prefetchedBytes > prefetchedPeakBytes) prefetchedPeakBytes = prefetchedBytes;
+    prefetchBuilds++;
+    lastUsed[index] = ++useCounter;
+    return true;
+}
+
+uint32_t AppManager::serviceNavigation() {
+    if (!navPending) return UINT32_MAX;
+
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&navLock);
+    int delta = pendingDelta;
+    int64_t detentAt = lastNavUs;
+    int64_t settleAt = lastNavUs + (int64_t)navWindowMs * 1000;
+    bool commit = navLeading || now >= settleAt;
+    if (commit) {
+        pendingDelta = 0;
+        navPending = false;
+        navLeading = false;
+    }
+    portEXIT_CRITICAL(&navLock);
+
+    // Still spinning - only move the cheap name indicator
+    if (!commit) {
+        showNavIndicator(wrapIndex(currentIndex + delta));
+        return (uint32_t)((settleAt - now + 999) / 1000);
+    }
+
+    // A lone detent lands straight away; in a burst only the final destination is built
+    hideNavIndicator();
+    switchBy(delta);
+    navCommits++;
+
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - detentAt);
+    burstLatencyTotalUs += latency;
+    if (latency > burstLatencyMaxUs) burstLatencyMaxUs = latency;
+    return UINT32_MAX;
+}
+
+void AppManager::showNavIndicator(int index) {
+    if (!navIndicator) {
+        navIndicator = lv_label_create(lv_layer_top());
+        lv_obj_set_style_bg_color(navIndicator, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(navIndicator, LV_OPA_80, 0);
+        lv_obj_set_style_text_color(navIndicator, lv_color_white(), 0);
+        lv_obj_set_style_radius(navIndicator, 12, 0);
+        lv_obj_set_style_pad_hor(navIndicator, 16, 0);
+        lv_obj_set_style_pad_ver(navIndicator, 8, 0);
+        lv_obj_align(navIndicator, LV_ALIGN_CENTER, 0, 0);
+    }
+
+    if (index != navIndicatorIndex) {
+        lv_label_set_text_static(navIndicator, apps[index]->getName());
+        navIndicatorIndex = index;
+    }
+    lv_obj_clear_flag(navIndicator, LV_OBJ_FLAG_HIDDEN);
+}
+
+void AppManager::hideNavIndicator() {
+    if (navIndicator) {
+        lv_obj_add_flag(navIndicator, LV_OBJ_FLAG_HIDDEN);
+        navIndicatorIndex = -1;
+    }
+}
+
+bool AppManager::startBackgroundTask() {
+    if (backgroundTaskHandle) return true;
+
+    BaseType_t result = xTaskCreate(
+        backgroundTask,
+        "app_bg_task",
+        BACKGROUND_TASK_STACK,
+        this,
+        BACKGROUND_TASK_PRIO,
+        &backgroundTaskHandle
+    );
+
+    return result == pdPASS;
+}
+
+// Data-only work off the UI task; sleeps until the earliest period comes
+// round, or for good when no app declares one
+void AppManager::backgroundTask(void* arg) {
+    AppManager* self = static_cast<AppManager*>(arg);
+
+    while (1) {
+        uint32_t waitMs = self->runBackgroundUpdates();
+        TickType_t ticks = waitMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(waitMs) + 1;
+        ulTaskNotifyTake(pdTRUE, ticks);
+    }
+}
+
+// Background task only - apps share state with their view under their own lock
+uint32_t AppManager::runBackgroundUpdates() {
+    int64_t now = esp_timer_get_time();
+    int64_t nextDue = INT64_MAX;
+
+    // Every app's data work runs here whether its screen is shown, suspended or evicted
+    for (int i = 0; i < appCount; i++) {
+        BaseApp::Schedule schedule = apps[i]->getSchedule();
+        if (schedule.backgroundPeriodMs == 0) continue;
+
+        if (now >= nextBackgroundUs[i]) {
+            int64_t start = esp_timer_get_time();
+            apps[i]->updateBackground();
+            uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+            portENTER_CRITICAL(&statsLock);
+            recordRun(backgroundStats[i], elapsed, schedule.budgetUs);
+            portEXIT_CRITICAL(&statsLock);
+            nextBackgroundUs[i] = now + (int64_t)schedule.backgroundPeriodMs * 1000;
+        }
+        if (nextBackgroundUs[i] < nextDue) nextDue = nextBackgroundUs[i];
+    }
+
+    if (nextDue == INT64_MAX) return UINT32_MAX;
+    now = esp_timer_get_time();
+    return nextDue > now ? (uint32_t)((nextDue - now) / 1000) : 0;
+}
+
+void AppManager::recordRun(UpdateStats& stats, uint32_t elapsedUs, uint32_t budgetUs) {
+    stats.runs++;
+    stats.totalUs += elapsedUs;
+    if (elapsedUs > stats.maxUs) stats.maxUs = elapsedUs;
+    if (budgetUs && elapsedUs > budgetUs) stats.overruns++;
+}
+
+void AppManager::setResidentScreenBudget(int screens) {
+    residentBudget = screens < 1 ? 1 : screens;
+
+    // Shrink immediately if we are over the new budget
+    trimResident(residentBudget, currentIndex);
+}
+
+int AppManager::getResidentScreenCount() const {
+    int count = 0;
+    for (int i = 0; i < appCount; i++) {
+        if (apps[i]->isInitialized()) count++;
+    }
+    return count;
+}
+
+void AppManager::printStatus() const {
+    float seconds = (millis() - statsSince) / 1000.0f;
+    if (seconds <= 0) seconds = 1;
+
+    Serial.println("\n=== APPS ===");
+    Serial.printf("Resident screens: %d / %d\n", getResidentScreenCount(), residentBudget);
+    Serial.println("  #  name       state      fg/bg ms   fg runs  avg/max us  over | bg runs  avg/max us  over  cpu%");
+    for (int i = 0; i < appCount; i++) {
+        BaseApp::Schedule schedule = apps[i]->getSchedule();
+        const UpdateStats& fg = foregroundStats[i];
+        portENTER_CRITICAL(&statsLock);
+        UpdateStats bg = backgroundStats[i];
+        portEXIT_CRITICAL(&statsLock);
+        float cpu = (fg.totalUs + bg.totalUs) / (seconds * 10000.0f);
+
+        Serial.printf("%c %2d %-10s %-10s %4lu/%-5lu %8lu %5lu/%-6lu %4lu | %7lu %5lu/%-6lu %4lu %5.2f\n",
+                      i == currentIndex ? '>' : ' ', i, apps[i]->getName(),
+                      BaseApp::stateName(apps[i]->getState()),
+                      schedule.foregroundPeriodMs, schedule.backgroundPeriodMs,
+                      fg.runs, fg.runs ? (uint32_t)(fg.totalUs / fg.runs) : 0, fg.maxUs, fg.overruns,
+                      bg.runs, bg.runs ? (uint32_t)(bg.totalUs / bg.runs) : 0, bg.maxUs, bg.overruns,
+                      cpu);
+    }
+
+    // Every detent used to be a full switch; now a burst costs at most two
+    uint32_t avgSwitchUs = switches ? (uint32_t)(switchTotalUs / switches) : 0;
+    uint32_t avoided = navDetents > navCommits ? navDetents - navCommits : 0;
+    Serial.printf("Navigation (window %lu ms): %lu detents in %lu bursts, %lu switches\n",
+                  navWindowMs, navDetents, navBursts, switches);
+    Serial.printf("  switch cost avg %lu us, max %lu us\n", avgSwitchUs, switchMaxUs);
+    if (navCommits) {
+        Serial.printf("  last detent to screen avg %lu ms, max %lu ms\n",
+                      (uint32_t)(burstLatencyTotalUs / navCommits / 1000), burstLatencyMaxUs / 1000);
+    }
+    Serial.printf("  %lu intermediate switches avoided (~%lu ms of switch work)\n",
+                  avoided, (uint32_t)((uint64_t)avoided * avgSwitchUs / 1000));
+    if (switches) {
+        Serial.printf("  LVGL blocks per switch: %.1f allocated by builds, %.1f freed by evictions\n",
+                      (float)buildBlocks / switches, (float)evictBlocks / switches);
+    }
+
+    uint32_t lookups = prefetchHits + residentHits + buildMisses;
+    Serial.printf("Prefetch: %s, budget %u bytes\n", prefetchEnabled ? "on" : "off", (unsigned)prefetchBudget);
+    Serial.printf("  %lu built, %lu hits, %lu wasted; hit rate %.0f%% (%lu resident, %lu built on demand)\n",
+                  prefetchBuilds, prefetchHits, prefetchWasted,
+                  lookups ? prefetchHits * 100.0f / lookups : 0.0f, residentHits, buildMisses);
+    Serial.printf("  added memory %u bytes now, %u peak\n", (unsigned)prefetchedBytes, (unsigned)prefetchedPeakBytes);
+    Serial.println("============\n");
+}
+
+void AppManager::resetStats() {
+    memset(foregroundStats, 0, sizeof(foregroundStats));
+    portENTER_CRITICAL(&statsLock);
+    memset(backgroundStats, 0, sizeof(backgroundStats));
+    portEXIT_CRITICAL(&statsLock);
+    navDetents = navBursts = navCommits = switches = 0;
+    buildBlocks = evictBlocks = 0;
+    switchTotalUs = burstLatencyTotalUs = 0;
+    switchMaxUs = burstLatencyMaxUs = 0;
+    prefetchBuilds = prefetchHits = prefetchWasted = residentHits = buildMisses = 0;
+    prefetchedPeakBytes = prefetchedBytes;
+    statsSince = millis();
 }
 
 void AppManager::switchToCurrentApp() {
-    if (!currentNode || !currentNode->app) return;
-    
-    // Initialize and enter the current app
-    if (currentNode->app->init()) {
-        currentNode->app->onEnter();
-        Serial.printf("Switched to app: %s\n", currentNode->app->getName());
+    BaseApp* app = getCurrentApp();
+    if (!app) return;
+
+    // Build the screen on first visit (or after eviction), otherwise just resume it
+    int64_t start = esp_timer_get_time();
+    if (prefetched[currentIndex]) {
+        prefetchHits++;
+        prefetched[currentIndex] = false;
+        prefetchedBytes -= memStats[currentIndex].lvglBytes;
+    } else if (app->isInitialized()) {
+        residentHits++;
     } else {
-        Serial.printf("Failed to initialize app: %s\n", currentNode->app->getName());
+        buildMisses++;
+        // Evict before building so peak memory stays within the budget; the
+        // screen still shown can only go once the new one is loaded below
+        trimResident(residentBudget - 1, currentIndex);
+        buildScreen(currentIndex);
+    }
+
+    if (app->activate()) {
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+        switches++;
+        switchTotalUs += elapsed;
+        if (elapsed > switchMaxUs) switchMaxUs = elapsed;
+
+        lastUsed[currentIndex] = ++useCounter;
+        trimResident(residentBudget, currentIndex);
+        lastSwitchUs = esp_timer_get_time();
+        nextForegroundUs = 0;  // Give the new app a view update straight away
+        Serial.printf("Switched to app: %s\n", app->getName());
+    } else {
+        Serial.printf("Failed to initialize app: %s\n", app->getName());
+    }
+    publishMemorySnapshot();  // Suspend and resume change states without a build
+}
+
+static void countObjects(lv_obj_t* obj, uint16_t& objects, uint16_t& styles) {
+    objects++;
+    styles += obj->style_cnt;
+    uint32_t children = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < children; i++) {
+        countObjects(lv_obj_get_child(obj, i), objects, styles);
+    }
+}
+
+bool AppManager::buildScreen(int index) {
+    // Everything LVGL allocates while the app builds its screen is charged to
+    // it, plus the widgets it borrowed from the pool - allocated at boot on
+    // the parking screen, so the delta alone would miss them
+    lv_mem_monitor_t before;
+    lv_mem_monitor(&before);
+    size_t lentBefore = WidgetPool::lentBytesTotal();
+    if (!apps[index]->prefetch()) return false;
+    lv_mem_monitor_t after;
+    lv_mem_monitor(&after);
+
+    MemoryStats& mem = memStats[index];
+    mem.lvglBytes = before.free_size > after.free_size ? before.free_size - after.free_size : 0;
+    mem.lvglBytes += WidgetPool::lentBytesTotal() - lentBefore;
+    if (mem.lvglBytes > mem.peakBytes) mem.peakBytes = mem.lvglBytes;
+    mem.builds++;
+    if (after.used_cnt > before.used_cnt) buildBlocks += after.used_cnt - before.used_cnt;
+    mem.objects = 0;
+    mem.styles = 0;
+    countObjects(apps[index]->getScreen(), mem.objects, mem.styles);
+
+    bool over = (mem.warnBytes && mem.lvglBytes > mem.warnBytes) ||
+                (mem.warnObjects && mem.objects > mem.warnObjects);
+    if (over && !mem.overLimit) {
+        Serial.printf("WARNING: app '%s' screen uses %u LVGL bytes / %u objects (limit %u / %u)\n",
+                      apps[index]->getName(), (unsigned)mem.lvglBytes, mem.objects,
+                      (unsigned)mem.warnBytes, mem.warnObjects);
+    }
+    mem.overLimit = over;
+    publishMemorySnapshot();
+    return true;
+}
+
+// UI task - the only place the status snapshot is written
+void AppManager::publishMemorySnapshot() {
+    MemorySnapshot fresh[MAX_APPS];
+    for (int i = 0; i < appCount; i++) {
+        const MemoryStats& mem = memStats[i];
+        fresh[i] = { apps[i]->getName(), apps[i]->getState(), mem.lvglBytes, mem.objects, mem.styles, mem.overLimit };
+    }
+
+    portENTER_CRITICAL(&snapshotLock);
+    memcpy(memSnapshot, fresh, sizeof(MemorySnapshot) * appCount);
+    memSnapshotCount = appCount;
+    portEXIT_CRITICAL(&snapshotLock);
+}
+
+// Preferences keys are limited to 15 characters
+static void memoryLimitKey(char* key, size_t size, char prefix, const char* appName) {
+    snprintf(key, size, "m%c_%.11s", prefix, appName);
+}
+
+void AppManager::loadMemoryLimits(int index) {
+    char bytesKey[16];
+    char objectsKey[16];
+    memoryLimitKey(bytesKey, sizeof(bytesKey), 'b', apps[index]->getName());
+    memoryLimitKey(objectsKey, sizeof(objectsKey), 'o', apps[index]->getName());
+
+    Preferences prefs;
+    prefs.begin("config", true);
+    memStats[index].warnBytes = prefs.getUInt(bytesKey, DEFAULT_WARN_BYTES);
+    memStats[index].warnObjects = prefs.getUShort(objectsKey, DEFAULT_WARN_OBJECTS);
+    prefs.end();
+}
+
+bool AppManager::setMemoryLimit(const char* appName, size_t bytes, uint16_t objects) {
+    for (int i = 0; i < appCount; i++) {
+        if (strcasecmp(apps[i]->getName(), appName) != 0) continue;
+
+        memStats[i].warnBytes = bytes;
+        memStats[i].warnObjects = objects;
+
+        char bytesKey[16];
+        char objectsKey[16];
+        memoryLimitKey(bytesKey, sizeof(bytesKey), 'b', apps[i]->getName());
+        memoryLimitKey(objectsKey, sizeof(objectsKey), 'o', apps[i]->getName());
+
+        Preferences prefs;
+        prefs.begin("config", false);
+        prefs.putUInt(bytesKey, bytes);
+        prefs.putUShort(objectsKey, objects);
+        prefs.end();
+        return true;
     }
+    return false;
+}
+
+void AppManager::printMemory() const {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    Serial.println("\n=== APP MEMORY ===");
+    Serial.printf("LVGL pool: %u / %u bytes used (%u%%), %u%% fragmented\n",
+                  (unsigned)(mon.total_size - mon.free_size), (unsigned)mon.total_size,
+                  mon.used_pct, mon.frag_pct);
+    Serial.println("  name       state       lvgl B   peak B  objs  styles  builds   limit B/objs");
+    for (int i = 0; i < appCount; i++) {
+        const MemoryStats& mem = memStats[i];
+        Serial.printf("  %-10s %-10s %7u  %7u  %4u  %6u  %6lu  %7u/%-4u %s\n",
+                      apps[i]->getName(), BaseApp::stateName(apps[i]->getState()),
+                      (unsigned)mem.lvglBytes, (unsigned)mem.peakBytes, mem.objects, mem.styles,
+                      mem.builds, (unsigned)mem.warnBytes, mem.warnObjects,
+                      mem.overLimit ? "OVER" : "");
+    }
+    Serial.printf("Figures are from the last build of each screen; borrowed pool widgets are included (pool %s)\n",
+                  WidgetPool::isEnabled() ? "on" : "off");
+    Serial.println("==================\n");
+}
+
+// Runs on the MQTT task: only the snapshot the UI task published, never LVGL or live app state
+void AppManager::addMemoryStatus(JsonDocument& doc) const {
+    MemorySnapshot snapshot[MAX_APPS];
+    portENTER_CRITICAL(&snapshotLock);
+    int count = memSnapshotCount;
+    memcpy(snapshot, memSnapshot, sizeof(MemorySnapshot) * count);
+    portEXIT_CRITICAL(&snapshotLock);
+
+    JsonArray list = doc["apps"].to<JsonArray>();
+    for (int i = 0; i < count; i++) {
+        const MemorySnapshot& mem = snapshot[i];
+        JsonObject entry = list.add<JsonObject>();
+        entry["name"] = mem.name;
+        entry["state"] = BaseApp::stateName(mem.state);
+        entry["lvgl_bytes"] = mem.lvglBytes;
+        entry["objects"] = mem.objects;
+        entry["styles"] = mem.styles;
+        entry["over_limit"] = mem.overLimit;
+    }
+}
+
+bool AppManager::trimResident(int limit, int keepIndex, int alsoKeep) {
+    // Only suspended screens can go, and never the one LVGL is still showing
+    screen_slot_t slots[MAX_APPS];
+    lv_obj_t* shown = lv_scr_act();
+    for (int i = 0; i < appCount; i++) {
+        slots[i].last_used = lastUsed[i];
+        slots[i].built = apps[i]->isInitialized();
+        slots[i].evictable = i != currentIndex && apps[i]->getState() == BaseApp::State::Suspended &&
+                             apps[i]->getScreen() != shown;
+    }
+    return screen_residency_trim(slots, appCount, limit, keepIndex, alsoKeep, evictSlot, this);
+}
+
+bool AppManager::evictSlot(int index, void* ctx) {
+    return static_cast<AppManager*>(ctx)->evictApp(index);
+}
+
+bool AppManager::evictApp(int victim) {
+    lv_mem_monitor_t before;
+    lv_mem_monitor(&before);
+    if (!apps[victim]->evict()) return false;
+    lv_mem_monitor_t after;
+    lv_mem_monitor(&after);
+    if (before.used_cnt > after.used_cnt) evictBlocks += before.used_cnt - after.used_cnt;
+    Serial.printf("Evicted screen of app: %s\n", apps[victim]->getName());
+    publishMemorySnapshot();
+
+    if (prefetched[victim]) {
+        prefetchWasted++;
+        prefetched[victim] = false;
+        prefetchedBytes -= memStats[victim].lvglBytes;
+    }
+    return true;
+}
+
+int AppManager::wrapIndex(int index) const {
+    index %= appCount;
+    return index < 0 ? index + appCount : index;
 }
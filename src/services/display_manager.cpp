@@ -1,11 +1,18 @@
 #include "display_manager.h"
+#include "redraw_debug.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 
 // Static member definitions
 lv_disp_draw_buf_t DisplayManager::draw_buf;
-lv_color_t DisplayManager::buf1[EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT];
-lv_color_t DisplayManager::buf2[EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT];
+lv_color_t* DisplayManager::buf1 = nullptr;
+lv_color_t* DisplayManager::buf2 = nullptr;
+lv_color_t DisplayManager::idleBuf[EXAMPLE_LCD_H_RES * IDLE_BUF_LINES];
 lv_disp_drv_t DisplayManager::disp_drv;
 lv_indev_drv_t DisplayManager::indev_drv;
+bool DisplayManager::renderingSuspended = false;
+FrameStats DisplayManager::frameStats;
+uint32_t DisplayManager::pendingFlushUs = 0;
 
 bool DisplayManager::initLVGL() {
     Serial.println("Initializing LVGL system...");
@@ -27,13 +34,19 @@ bool DisplayManager::initDisplay() {
     }
     
     // Initialize display buffer with proper sizing
-    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT);
+    if (!allocDrawBuffers()) {
+        Serial.println("Failed to allocate display buffers");
+        return false;
+    }
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, DRAW_BUF_PIXELS);
     
     // Initialize display driver
     lv_disp_drv_init(&disp_drv);
     disp_drv.hor_res = EXAMPLE_LCD_H_RES;
     disp_drv.ver_res = EXAMPLE_LCD_V_RES;
-    disp_drv.flush_cb = LcdDriver::display_flush_cb;
+    disp_drv.flush_cb = flush_cb;
+    disp_drv.rounder_cb = LcdDriver::rounder_cb;
+    disp_drv.monitor_cb = monitor_cb;
     disp_drv.draw_buf = &draw_buf;
     
     // Register the driver
@@ -72,9 +85,117 @@ bool DisplayManager::initInput() {
     return true;
 }
 
-void DisplayManager::handleLVGLTasks() {
+uint32_t DisplayManager::handleLVGLTasks() {
     // Handle LVGL tasks - should be called regularly in main loop
-    lv_timer_handler();
+    if (renderingSuspended) return LV_NO_TIMER_READY;
+    return lv_timer_handler();
+}
+
+void DisplayManager::flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
+    // Nothing may reach the panel while another owner (the always-on clock) draws on it
+    if (renderingSuspended) {
+        lv_disp_flush_ready(disp);
+        return;
+    }
+    
+    int64_t start = esp_timer_get_time();
+#ifdef DISPLAY_REDRAW_DEBUG
+    // Debug builds route flushes through the redraw-region overlay
+    RedrawDebug::flush_cb(disp, area, color_p);
+#else
+    LcdDriver::display_flush_cb(disp, area, color_p);
+#endif
+    pendingFlushUs += (uint32_t)(esp_timer_get_time() - start);
+}
+
+void DisplayManager::monitor_cb(lv_disp_drv_t *disp, uint32_t time, uint32_t px) {
+    // time covers the whole refresh (render + flush) in ms
+    uint32_t totalUs = time * 1000;
+    frameStats.frames++;
+    // Transfers overlap rendering into the other buffer, so this is not part of totalUs;
+    // the last flush of a frame may still be in flight and lands in the next one
+    frameStats.flushUs += LcdDriver::takeFlushBusyUs();
+    frameStats.renderUs += totalUs > pendingFlushUs ? totalUs - pendingFlushUs : 0;
+    frameStats.pixels += px;
+    pendingFlushUs = 0;
+    
+#ifdef DISPLAY_REDRAW_DEBUG
+    RedrawDebug::monitor_cb(disp, time, px);
+#endif
+}
+
+FrameStats DisplayManager::takeFrameStats() {
+    FrameStats stats = frameStats;
+    frameStats = FrameStats();
+    return stats;
+}
+
+bool DisplayManager::allocDrawBuffers() {
+    // Heap-allocated (DMA capable) so they can be released while rendering is suspended
+    buf1 = (lv_color_t*)heap_caps_malloc(DRAW_BUF_PIXELS * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    buf2 = (lv_color_t*)heap_caps_malloc(DRAW_BUF_PIXELS * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    if (!buf1 || !buf2) {
+        freeDrawBuffers();
+        return false;
+    }
+    return true;
+}
+
+void DisplayManager::freeDrawBuffers() {
+    heap_caps_free(buf1);
+    heap_caps_free(buf2);
+    buf1 = nullptr;
+    buf2 = nullptr;
+}
+
+size_t DisplayManager::suspendRendering() {
+    if (renderingSuspended) return 0;
+    
+    lv_disp_t* disp = lv_disp_get_default();
+    if (disp && disp->refr_timer) {
+        lv_timer_pause(disp->refr_timer);
+    }
+    
+    // The last flush of a refresh can still be on the bus - its buffer must
+    // outlive the DMA transfer, so give up rather than free it underneath
+    if (!LcdDriver::waitFlushDone(FLUSH_WAIT_MS) || draw_buf.flushing) {
+        if (disp && disp->refr_timer) {
+            lv_timer_resume(disp->refr_timer);
+        }
+        Serial.println("Rendering not suspended - a flush is still in flight");
+        return 0;
+    }
+    
+    // Anything that still renders (lv_refr_now) lands in a two-line static
+    // buffer and is dropped by flush_cb instead of writing to freed memory
+    renderingSuspended = true;
+    lv_disp_draw_buf_init(&draw_buf, idleBuf, nullptr, EXAMPLE_LCD_H_RES * IDLE_BUF_LINES);
+    freeDrawBuffers();
+    
+    size_t released = 2 * DRAW_BUF_PIXELS * sizeof(lv_color_t);
+    Serial.printf("Rendering suspended, released %u bytes of draw buffers\n", released);
+    return released;
+}
+
+bool DisplayManager::resumeRendering() {
+    if (!renderingSuspended) return true;
+    
+    if (!allocDrawBuffers()) {
+        Serial.println("Failed to reallocate display buffers");
+        return false;
+    }
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, DRAW_BUF_PIXELS);
+    renderingSuspended = false;
+    
+    lv_disp_t* disp = lv_disp_get_default();
+    if (disp && disp->refr_timer) {
+        lv_timer_resume(disp->refr_timer);
+    }
+    
+    // The panel content was replaced while suspended - repaint everything
+    lv_obj_invalidate(lv_scr_act());
+    Serial.println("Rendering resumed");
+    return true;
 }
 
 void DisplayManager::shutdown() {
@@ -92,7 +213,7 @@ void DisplayManager::printDisplayInfo() {
     Serial.println("=== Display System Info ===");
     Serial.printf("LVGL Version: %d.%d.%d\n", LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH);
     Serial.printf("Screen Resolution: %dx%d\n", getScreenWidth(), getScreenHeight());
-    Serial.printf("Buffer Size: %d pixels\n", EXAMPLE_LCD_H_RES * EXAMPLE_LVGL_BUF_HEIGHT);
+    Serial.printf("Buffer Size: %d pixels\n", (int)DRAW_BUF_PIXELS);
     Serial.println("===========================");
     
     // Also print hardware info
@@ -0,0 +1,157 @@
+#include "input_frame.h"
+#include "esp_timer.h"
+
+// Static member definitions
+InputSnapshot InputFrame::pending = {};
+bool InputFrame::touchWasDown = false;
+int16_t InputFrame::lastX = 0;
+int16_t InputFrame::lastY = 0;
+int64_t InputFrame::lastDeliveryUs = 0;
+portMUX_TYPE InputFrame::lock = portMUX_INITIALIZER_UNLOCKED;
+uint32_t InputFrame::knobBatches = 0;
+uint32_t InputFrame::touchMoves = 0;
+uint32_t InputFrame::gestures = 0;
+uint32_t InputFrame::snapshots = 0;
+uint32_t InputFrame::maxDetents = 0;
+
+static int16_t clampAdd(int16_t a, int b) {
+    int sum = a + b;
+    if (sum > INT16_MAX) return INT16_MAX;
+    if (sum < INT16_MIN) return INT16_MIN;
+    return (int16_t)sum;
+}
+
+// Encoder task
+void InputFrame::addKnob(const EncoderBatch& batch) {
+    portENTER_CRITICAL(&lock);
+    pending.knobDelta += batch.delta;
+    pending.knobSteps += batch.steps;
+    pending.knobDetents += batch.events;
+    pending.knobVelocity = batch.velocity;
+    knobBatches++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void InputFrame::addKeyPress() {
+    portENTER_CRITICAL(&lock);
+    if (pending.keyPresses < 255) pending.keyPresses++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void InputFrame::addTouch(bool pressed, int16_t x, int16_t y) {
+    // Released and staying released - the common case on every pointer read
+    if (!pressed && !touchWasDown) return;
+
+    portENTER_CRITICAL(&lock);
+    if (pressed && !touchWasDown) {
+        if (pending.touchDowns < 255) pending.touchDowns++;
+    } else if (!pressed) {
+        if (pending.touchUps < 255) pending.touchUps++;
+    } else if (x != lastX || y != lastY) {
+        pending.touchDx = clampAdd(pending.touchDx, x - lastX);
+        pending.touchDy = clampAdd(pending.touchDy, y - lastY);
+        touchMoves++;
+    }
+    pending.touching = pressed;
+    if (pressed) {
+        pending.touchX = x;
+        pending.touchY = y;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    touchWasDown = pressed;
+    lastX = x;
+    lastY = y;
+}
+
+void InputFrame::addGesture(const touch_gesture_event_t& event) {
+    portENTER_CRITICAL(&lock);
+    switch (event.type) {
+        case TOUCH_GESTURE_TAP:
+            if (pending.taps < 255) pending.taps++;
+            break;
+        case TOUCH_GESTURE_DOUBLE_TAP:
+            if (pending.doubleTaps < 255) pending.doubleTaps++;
+            break;
+        case TOUCH_GESTURE_LONG_PRESS:
+            if (pending.longPresses < 255) pending.longPresses++;
+            break;
+        case TOUCH_GESTURE_SWIPE:
+            pending.swipe = event.swipe;
+            break;
+        case TOUCH_GESTURE_ROTATE:
+            pending.rotateSteps += event.steps;
+            pending.rotateAngle += event.angle;
+            break;
+        default:
+            break;
+    }
+    gestures++;
+    portEXIT_CRITICAL(&lock);
+}
+
+void InputFrame::discardKnob() {
+    portENTER_CRITICAL(&lock);
+    pending.knobDelta = 0;
+    pending.knobSteps = 0;
+    pending.knobDetents = 0;
+    pending.knobVelocity = 0;
+    pending.keyPresses = 0;
+    portEXIT_CRITICAL(&lock);
+}
+
+bool InputFrame::take(InputSnapshot& out) {
+    portENTER_CRITICAL(&lock);
+    out = pending;
+    // Per-frame fields restart; the finger's state and position carry over
+    pending.knobDelta = 0;
+    pending.knobSteps = 0;
+    pending.knobDetents = 0;
+    pending.keyPresses = 0;
+    pending.touchDowns = 0;
+    pending.touchUps = 0;
+    pending.touchDx = 0;
+    pending.touchDy = 0;
+    pending.taps = 0;
+    pending.doubleTaps = 0;
+    pending.longPresses = 0;
+    pending.swipe = TOUCH_SWIPE_NONE;
+    pending.rotateSteps = 0;
+    pending.rotateAngle = 0;
+    portEXIT_CRITICAL(&lock);
+
+    if (!out.hasKnob() && !out.hasTouch()) return false;
+
+    int64_t now = esp_timer_get_time();
+    out.sinceUs = lastDeliveryUs ? (uint32_t)(now - lastDeliveryUs) : 0;
+    lastDeliveryUs = now;
+    snapshots++;
+    if (out.knobDetents > maxDetents) maxDetents = out.knobDetents;
+    return true;
+}
+
+void InputFrame::printStats() {
+    Serial.println("\n=== INPUT FRAMES ===");
+    Serial.printf("Snapshots: %lu delivered to apps\n", snapshots);
+    Serial.printf("Folded in: %lu knob batches, %lu touch moves, %lu gestures\n", knobBatches, touchMoves, gestures);
+    Serial.printf("Largest:   %lu detents in one frame\n", maxDetents);
+    Serial.printf("Touch:     %s\n", touchWasDown ? "down" : "up");
+    Serial.println("====================\n");
+}
+
+void InputFrame::resetStats() {
+    knobBatches = 0;
+    touchMoves = 0;
+    gestures = 0;
+    snapshots = 0;
+    maxDetents = 0;
+}
+
+// C entry points
+extern "C" void input_frame_touch(bool pressed, int16_t x, int16_t y) {
+    InputFrame::addTouch(pressed, x, y);
+}
+
+extern "C" void input_frame_gesture(const touch_gesture_event_t* event) {
+    InputFrame::addGesture(*event);
+}
@@ -0,0 +1,189 @@
+#include "knob_input.h"
+#include "app_manager.h"
+#include "ui_scheduler.h"
+#include "input_frame.h"
+
+// Static member definitions
+lv_indev_drv_t KnobInput::indevDrv;
+lv_indev_t* KnobInput::indev = nullptr;
+portMUX_TYPE KnobInput::lock = portMUX_INITIALIZER_UNLOCKED;
+volatile KnobInput::Mode KnobInput::mode = KnobInput::Mode::Navigate;
+volatile bool KnobInput::toApp = false;
+int KnobInput::pendingDiff = 0;
+uint8_t KnobInput::pendingPresses = 0;
+bool KnobInput::keyDown = false;
+volatile bool KnobInput::readPending = false;
+lv_obj_t* KnobInput::boundScreen = nullptr;
+lv_group_t* KnobInput::boundGroup = nullptr;
+bool KnobInput::boundUsesKnob = false;
+uint32_t KnobInput::reads = 0;
+uint32_t KnobInput::focusDetents = 0;
+uint32_t KnobInput::presses = 0;
+
+bool KnobInput::begin() {
+    if (indev) return true;
+
+    lv_indev_drv_init(&indevDrv);
+    indevDrv.type = LV_INDEV_TYPE_ENCODER;
+    indevDrv.read_cb = readCb;
+    indev = lv_indev_drv_register(&indevDrv);
+    if (!indev) return false;
+
+    // Event driven - service() reads the device only when input is buffered
+    lv_timer_pause(indevDrv.read_timer);
+
+    return EncoderManager::addListener(onBatch);
+}
+
+// Encoder task - never touches LVGL
+void KnobInput::onBatch(const EncoderBatch& batch, void* ctx) {
+    if (mode == Mode::Navigate) {
+        appManager.onEncoderChange(batch.delta);
+        return;
+    }
+    if (toApp) {
+        InputFrame::addKnob(batch);
+        focusDetents += batch.events;
+        return;
+    }
+
+    portENTER_CRITICAL(&lock);
+    pendingDiff += batch.delta;
+    focusDetents += batch.events;
+    portEXIT_CRITICAL(&lock);
+    readPending = true;
+}
+
+void KnobInput::service() {
+    if (!indev) return;
+    bindCurrentApp();
+
+    if (readPending) {
+        readPending = false;
+        lv_indev_read_timer_cb(indevDrv.read_timer);
+    }
+}
+
+void KnobInput::readCb(lv_indev_drv_t* drv, lv_indev_data_t* data) {
+    reads++;
+
+    // Rotation only counts while the key is up, so a click is a read on its own
+    data->enc_diff = 0;
+    if (keyDown) {
+        keyDown = false;
+        data->state = LV_INDEV_STATE_RELEASED;
+        data->continue_reading = pendingPresses > 0 || pendingDiff != 0;
+        return;
+    }
+
+    portENTER_CRITICAL(&lock);
+    bool startPress = pendingPresses > 0;
+    if (startPress) {
+        pendingPresses--;
+    } else {
+        int diff = pendingDiff;
+        if (diff > INT16_MAX) diff = INT16_MAX;
+        if (diff < INT16_MIN) diff = INT16_MIN;
+        pendingDiff -= diff;
+        data->enc_diff = (int16_t)diff;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    data->state = startPress ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    keyDown = startPress;
+    data->continue_reading = startPress;
+}
+
+void KnobInput::bindCurrentApp() {
+    BaseApp* app = appManager.getCurrentApp();
+    lv_obj_t* screen = app ? app->getScreen() : nullptr;
+    if (screen == boundScreen) return;
+
+    // New app (or a rebuilt screen) - always start by navigating
+    setMode(Mode::Navigate);
+    if (boundScreen && lv_obj_is_valid(boundScreen)) {
+        while (lv_obj_remove_event_cb(boundScreen, onScreenEvent)) {}
+    }
+
+    boundScreen = screen;
+    boundGroup = app ? app->getInputGroup() : nullptr;
+    boundUsesKnob = app && app->usesKnob();
+    lv_indev_set_group(indev, boundGroup);
+
+    // Only presses on the background itself arrive here - widgets keep their own
+    if (screen) {
+        lv_obj_add_event_cb(screen, onScreenEvent, LV_EVENT_LONG_PRESSED, nullptr);
+        lv_obj_add_event_cb(screen, onScreenEvent, LV_EVENT_SHORT_CLICKED, nullptr);
+    }
+}
+
+void KnobInput::onScreenEvent(lv_event_t* e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_LONG_PRESSED) {
+        setMode(mode == Mode::Navigate ? Mode::Focus : Mode::Navigate);
+    } else if (code == LV_EVENT_SHORT_CLICKED && mode == Mode::Focus) {
+        press();
+    }
+}
+
+bool KnobInput::setMode(Mode newMode) {
+    bool hasWidgets = boundGroup && lv_group_get_obj_count(boundGroup) > 0;
+    if (newMode == Mode::Focus && !hasWidgets && !boundUsesKnob) {
+        return false;  // Nothing in this app for the knob to drive
+    }
+
+    portENTER_CRITICAL(&lock);
+    mode = newMode;
+    toApp = newMode == Mode::Focus && !hasWidgets;
+    pendingDiff = 0;
+    pendingPresses = 0;
+    portEXIT_CRITICAL(&lock);
+    InputFrame::discardKnob();
+
+    if (!hasWidgets) return true;
+    lv_group_set_editing(boundGroup, false);
+
+    // Show the focus ring the way a real key press would
+    lv_obj_t* focused = lv_group_get_focused(boundGroup);
+    if (newMode == Mode::Focus) {
+        if (!focused) lv_group_focus_next(boundGroup);
+        focused = lv_group_get_focused(boundGroup);
+        if (focused) lv_obj_add_state(focused, LV_STATE_FOCUS_KEY);
+    } else if (focused) {
+        lv_obj_clear_state(focused, LV_STATE_FOCUS_KEY);
+    }
+    return true;
+}
+
+void KnobInput::press() {
+    if (mode != Mode::Focus) return;
+
+    presses++;
+    if (toApp) {
+        InputFrame::addKeyPress();
+        UiScheduler::notify(UI_EVENT_INPUT);
+        return;
+    }
+
+    portENTER_CRITICAL(&lock);
+    if (pendingPresses < 255) pendingPresses++;
+    portEXIT_CRITICAL(&lock);
+    readPending = true;
+    UiScheduler::notify(UI_EVENT_INPUT);
+}
+
+void KnobInput::printStatus() {
+    Serial.println("\n=== KNOB INPUT ===");
+    Serial.printf("Mode:     %s\n", mode == Mode::Navigate ? "navigate apps" : "focus widgets");
+    if (toApp) {
+        Serial.println("Group:    none - detents go to the app's onInput()");
+    } else if (boundGroup) {
+        Serial.printf("Group:    %lu widgets, %s\n", (unsigned long)lv_group_get_obj_count(boundGroup),
+                      lv_group_get_editing(boundGroup) ? "editing" : "moving focus");
+    } else {
+        Serial.println("Group:    none (app has no knob-driven widgets)");
+    }
+    Serial.printf("Reads:    %lu (event driven)\n", reads);
+    Serial.printf("Detents:  %lu to widgets, %lu key presses\n", focusDetents, presses);
+    Serial.println("==================\n");
+}
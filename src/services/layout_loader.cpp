@@ -0,0 +1,171 @@
+#include "layout_loader.h"
+#include "widget_pool.h"
+#include "ui_styles.h"
+#include <SPIFFS.h>
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+// The compiler writes lv_align_t values directly
+static_assert(LV_ALIGN_TOP_LEFT == 1 && LV_ALIGN_CENTER == 9, "lv_align_t values changed - update compile_layouts.py");
+
+// Static member definitions
+LayoutLoader::CachedLayout LayoutLoader::cache[MAX_LAYOUTS] = {};
+int LayoutLoader::cacheCount = 0;
+bool LayoutLoader::mounted = false;
+bool LayoutLoader::enabled = true;
+
+bool LayoutLoader::begin() {
+    if (mounted) return true;
+
+    // Don't format on failure - an empty partition just means no layouts
+    mounted = SPIFFS.begin(false);
+    Serial.printf("Layout storage %s\n", mounted ? "mounted" : "not available, using built-in screens");
+    return mounted;
+}
+
+const LayoutLoader::CachedLayout* LayoutLoader::find(const char* name) {
+    for (int i = 0; i < cacheCount; i++) {
+        if (strcmp(cache[i].name, name) == 0) {
+            return cache[i].data ? &cache[i] : nullptr;
+        }
+    }
+
+    if (!mounted || cacheCount >= MAX_LAYOUTS || strlen(name) >= sizeof(cache[0].name)) return nullptr;
+
+    // First use - read the file once and remember misses too
+    CachedLayout& entry = cache[cacheCount++];
+    strcpy(entry.name, name);
+
+    char path[40];
+    snprintf(path, sizeof(path), "/layouts/%s.bin", name);
+
+    int64_t start = esp_timer_get_time();
+    File file = SPIFFS.open(path, "r");
+    if (!file) return nullptr;
+
+    size_t size = file.size();
+    uint8_t* data = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (!data) data = (uint8_t*)malloc(size);
+    if (!data) {
+        file.close();
+        return nullptr;
+    }
+
+    size_t read = file.read(data, size);
+    file.close();
+
+    // Validate once here so load() can trust the records
+    const LayoutHeader* header = (const LayoutHeader*)data;
+    size_t expected = sizeof(LayoutHeader);
+    bool valid = read == size && size >= sizeof(LayoutHeader) &&
+                 header->magic == LAYOUT_MAGIC && header->version == LAYOUT_VERSION &&
+                 header->nodeCount > 0 && header->nodeCount <= MAX_NODES;
+    if (valid) {
+        expected += header->nodeCount * sizeof(LayoutNode) + header->stringBytes;
+        valid = size == expected;
+    }
+    if (valid) {
+        // A trailing NUL ends every string that starts inside the table
+        const LayoutNode* nodes = (const LayoutNode*)(data + sizeof(LayoutHeader));
+        const char* strings = (const char*)(nodes + header->nodeCount);
+        valid = nodes[0].type == LAYOUT_SCREEN && nodes[0].style <= LAYOUT_STYLE_CAPTION &&
+                (header->stringBytes == 0 || strings[header->stringBytes - 1] == '\0');
+        for (int i = 1; valid && i < header->nodeCount; i++) {
+            valid = nodes[i].parent < i && nodes[i].type != LAYOUT_SCREEN && nodes[i].type <= LAYOUT_ARC &&
+                    nodes[i].style <= LAYOUT_STYLE_CAPTION &&
+                    (nodes[i].text == LAYOUT_NO_TEXT || nodes[i].text < header->stringBytes);
+        }
+    }
+    if (!valid) {
+        Serial.printf("Layout %s is invalid, using built-in screen\n", path);
+        free(data);
+        return nullptr;
+    }
+
+    entry.data = data;
+    entry.size = size;
+    entry.readUs = (uint32_t)(esp_timer_get_time() - start);
+    return &entry;
+}
+
+lv_obj_t* LayoutLoader::load(const char* name, lv_obj_t** ids, int idCount) {
+    if (!enabled) return nullptr;
+
+    const CachedLayout* layout = find(name);
+    if (!layout) return nullptr;
+
+    const LayoutHeader* header = (const LayoutHeader*)layout->data;
+    const LayoutNode* nodes = (const LayoutNode*)(layout->data + sizeof(LayoutHeader));
+    const char* strings = (const char*)(nodes + header->nodeCount);
+
+    for (int i = 0; i < idCount; i++) ids[i] = nullptr;
+
+    lv_obj_t* objects[MAX_NODES];
+    for (int i = 0; i < header->nodeCount; i++) {
+        const LayoutNode& node = nodes[i];
+        lv_obj_t* parent = i ? objects[node.parent] : nullptr;
+        lv_obj_t* obj;
+
+        switch (node.type) {
+            case LAYOUT_SCREEN: obj = lv_obj_create(NULL); break;
+            case LAYOUT_LABEL:  obj = WidgetPool::label(parent); break;
+            case LAYOUT_SWITCH: obj = lv_switch_create(parent); break;
+            case LAYOUT_BAR:    obj = WidgetPool::bar(parent); break;
+            case LAYOUT_ARC:    obj = WidgetPool::arc(parent); break;
+            default:            obj = lv_obj_create(parent); break;
+        }
+        objects[i] = obj;
+
+        if (node.w != LAYOUT_SIZE_DEFAULT) lv_obj_set_width(obj, sizeFor(node.w));
+        if (node.h != LAYOUT_SIZE_DEFAULT) lv_obj_set_height(obj, sizeFor(node.h));
+        if (i) lv_obj_align(obj, (lv_align_t)node.align, node.x, node.y);
+
+        if (node.text != LAYOUT_NO_TEXT && node.type == LAYOUT_LABEL) {
+            lv_label_set_text_static(obj, strings + node.text);  // Cached for the firmware's lifetime
+        }
+        switch (node.style) {
+            case LAYOUT_STYLE_TITLE:   lv_obj_add_style(obj, UiStyles::title(), 0); break;
+            case LAYOUT_STYLE_BODY:    lv_obj_add_style(obj, UiStyles::body(), 0); break;
+            case LAYOUT_STYLE_CAPTION: lv_obj_add_style(obj, UiStyles::caption(), 0); break;
+            default: break;
+        }
+        if (node.font) {
+            // Shared style - a local font style would allocate per object
+            lv_style_t* style = UiStyles::font(node.font);
+            if (style) lv_obj_add_style(obj, style, 0);
+        }
+        if (node.textColor & LAYOUT_COLOR_SET) {
+            lv_obj_set_style_text_color(obj, lv_color_hex(node.textColor & 0xFFFFFF), 0);
+        }
+        if (node.bgColor & LAYOUT_COLOR_SET) {
+            lv_obj_set_style_bg_color(obj, lv_color_hex(node.bgColor & 0xFFFFFF), 0);
+            lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+        }
+        if (node.id && node.id < idCount) {
+            ids[node.id] = obj;
+        }
+    }
+
+    return objects[0];
+}
+
+lv_coord_t LayoutLoader::sizeFor(int16_t value) {
+    if (value == LAYOUT_SIZE_CONTENT) return LV_SIZE_CONTENT;
+    if (value <= LAYOUT_SIZE_PCT_BASE) return lv_pct(LAYOUT_SIZE_PCT_BASE - value);
+    return value;
+}
+
+void LayoutLoader::printStatus() {
+    Serial.println("\n=== LAYOUTS ===");
+    Serial.printf("Storage: %s, loader %s\n", mounted ? "mounted" : "not mounted", enabled ? "enabled" : "disabled");
+    for (int i = 0; i < cacheCount; i++) {
+        if (cache[i].data) {
+            const LayoutHeader* header = (const LayoutHeader*)cache[i].data;
+            Serial.printf("  %-10s %2u nodes %5u bytes, read in %lu us\n",
+                          cache[i].name, header->nodeCount, (unsigned)cache[i].size, cache[i].readUs);
+        } else {
+            Serial.printf("  %-10s not installed (built-in)\n", cache[i].name);
+        }
+    }
+    Serial.println("===============\n");
+}
@@ -1,4 +1,8 @@
 #include "mqtt_manager.h"
+#include "ui_scheduler.h"
+#include "esp_vfs_eventfd.h"
+#include <sys/select.h>
+#include <unistd.h>
 
 // Global instance
 MQTTManager mqttManager;
@@ -100,6 +104,7 @@ bool MQTTManager::connect() {
     
     if (result) {
         isConnected = true;
+        lastOutMs = millis();
         Serial.printf("MQTT connected as %s\n", config.clientId);
         
         // Subscribe to default topics automatically
@@ -153,6 +158,9 @@ bool MQTTManager::reconnect() {
 void MQTTManager::loop() {
     if (mqttClient.connected()) {
         mqttClient.loop();
+        if (mqttClient.connected() && millis() - lastOutMs >= keepAliveDeadlineMs()) {
+            sendPing();
+        }
     } else {
         if (isConnected) {
             // We were connected but lost connection
@@ -167,7 +175,166 @@ void MQTTManager::loop() {
     }
 }
 
+bool MQTTManager::startLoopTask() {
+    if (loopTaskHandle) return true;
+    
+    outbox = xQueueCreate(OUTBOX_LENGTH, sizeof(OutboundMessage*));
+    if (!outbox) return false;
+    
+    // Queued publishes wake the task through an eventfd so it can block in
+    // select() on the socket and the eventfd together
+    esp_vfs_eventfd_config_t eventfdConfig = ESP_VFS_EVENTD_CONFIG_DEFAULT();
+    esp_err_t err = esp_vfs_eventfd_register(&eventfdConfig);
+    if (err == ESP_OK || err == ESP_ERR_INVALID_STATE) {
+        wakeFd = eventfd(0, 0);
+    }
+    if (wakeFd < 0) {
+        Serial.printf("MQTT: no eventfd, checking the outbox every %lu ms\n", OUTBOX_POLL_MS);
+    }
+    
+    statsSince = millis();
+    BaseType_t result = xTaskCreate(
+        loopTask,
+        "mqtt_task",
+        6144,
+        this,
+        1,
+        &loopTaskHandle
+    );
+    
+    return result == pdPASS;
+}
+
+void MQTTManager::loopTask(void* arg) {
+    MQTTManager* self = static_cast<MQTTManager*>(arg);
+    
+    while (1) {
+        self->drainOutbox();
+        self->loop();
+        self->waitForWork(self->nextWaitMs());
+    }
+}
+
+bool MQTTManager::ownsClient() const {
+    return !loopTaskHandle || xTaskGetCurrentTaskHandle() == loopTaskHandle;
+}
+
+void MQTTManager::drainOutbox() {
+    OutboundMessage* msg;
+    while (xQueueReceive(outbox, &msg, 0) == pdTRUE) {
+        if (!publishNow(msg->topic.c_str(), msg->payload.c_str(), msg->retained)) {
+            publishesDropped++;
+        }
+        delete msg;
+    }
+}
+
+// Silence allowed after the last outbound packet before loop() pings. The
+// broker drops us after 1.5x keepAlive without traffic; PubSubClient only
+// pings once a full keepAlive has passed, and only if loop() happens to run
+// then, so we ping ourselves a margin before the deadline instead
+uint32_t MQTTManager::keepAliveDeadlineMs() const {
+    if (config.keepAlive <= 0) return UINT32_MAX;   // Keepalive disabled
+    uint32_t keepAliveMs = config.keepAlive * 1000UL;
+    uint32_t margin = keepAliveMs / 4;
+    if (margin > KEEPALIVE_MARGIN_MS) margin = KEEPALIVE_MARGIN_MS;
+    return keepAliveMs - margin;
+}
+
+// PINGREQ written straight to the socket: PubSubClient has no public ping call.
+// Its loop() consumes the PINGRESP like the reply to one of its own pings
+bool MQTTManager::sendPing() {
+    static const uint8_t pingReq[2] = { 0xC0, 0x00 };
+    if (wifiClient.write(pingReq, sizeof(pingReq)) != sizeof(pingReq)) {
+        // Drop the socket so the next loop() reconnects instead of retrying forever
+        Serial.println("MQTT keepalive ping failed");
+        wifiClient.stop();
+        return false;
+    }
+    lastOutMs = millis();
+    pingsSent++;
+    return true;
+}
+
+// Longest the task may sleep: until the keepalive deadline measured from the
+// last outbound packet, and reconnects are retried every reconnectInterval
+uint32_t MQTTManager::nextWaitMs() {
+    // Whole packets can already sit in WiFiClient's buffer where select() won't see them
+    if (isConnected && wifiClient.available()) return 0;
+    
+    uint32_t waitMs = config.reconnectInterval;
+    if (isConnected) {
+        uint32_t sinceOut = millis() - lastOutMs;
+        uint32_t deadline = keepAliveDeadlineMs();
+        waitMs = sinceOut >= deadline ? 0 : deadline - sinceOut;
+    }
+    if (wakeFd < 0 && waitMs > OUTBOX_POLL_MS) waitMs = OUTBOX_POLL_MS;
+    return waitMs;
+}
+
+void MQTTManager::waitForWork(uint32_t timeoutMs) {
+    if (timeoutMs == 0) return;
+    
+    fd_set readable;
+    FD_ZERO(&readable);
+    int maxFd = -1;
+    if (wakeFd >= 0) {
+        FD_SET(wakeFd, &readable);
+        maxFd = wakeFd;
+    }
+    int sock = isConnected ? wifiClient.fd() : -1;
+    if (sock >= 0) {
+        FD_SET(sock, &readable);
+        if (sock > maxFd) maxFd = sock;
+    }
+    
+    if (maxFd < 0) {
+        vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+        timeoutWakeups++;
+        return;
+    }
+    
+    struct timeval tv = { (time_t)(timeoutMs / 1000), (suseconds_t)((timeoutMs % 1000) * 1000) };
+    int ready = select(maxFd + 1, &readable, nullptr, nullptr, &tv);
+    if (ready <= 0) {
+        timeoutWakeups++;
+        return;
+    }
+    if (sock >= 0 && FD_ISSET(sock, &readable)) socketWakeups++;
+    if (wakeFd >= 0 && FD_ISSET(wakeFd, &readable)) {
+        uint64_t count;
+        read(wakeFd, &count, sizeof(count));
+        outboxWakeups++;
+    }
+}
+
 bool MQTTManager::publish(const char* topic, const char* payload, bool retained) {
+    if (ownsClient()) {
+        return publishNow(topic, payload, retained);
+    }
+    
+    if (!isConnected) {
+        Serial.println("MQTT not connected, cannot publish");
+        return false;
+    }
+    
+    OutboundMessage* msg = new OutboundMessage{ String(topic), String(payload), retained };
+    if (xQueueSend(outbox, &msg, 0) != pdTRUE) {
+        delete msg;
+        publishesDropped++;
+        Serial.printf("MQTT outbox full, dropped [%s]\n", topic);
+        return false;
+    }
+    publishesQueued++;
+    
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        write(wakeFd, &one, sizeof(one));
+    }
+    return true;
+}
+
+bool MQTTManager::publishNow(const char* topic, const char* payload, bool retained) {
     if (!mqttClient.connected()) {
         Serial.println("MQTT not connected, cannot publish");
         return false;
@@ -175,6 +342,7 @@ bool MQTTManager::publish(const char* topic, const char* payload, bool retained)
     
     bool result = mqttClient.publish(topic, payload, retained);
     if (result) {
+        lastOutMs = millis();
         Serial.printf("MQTT Published [%s]: %s\n", topic, payload);
     } else {
         Serial.printf("MQTT Publish failed [%s]\n", topic);
@@ -194,6 +362,10 @@ bool MQTTManager::publishJson(const char* topic, const JsonDocument& doc, bool r
 }
 
 bool MQTTManager::subscribe(const char* topic, uint8_t qos) {
+    if (!ownsClient()) {
+        Serial.println("MQTT subscribe must run on the MQTT task - use addSubscriptionTopic()");
+        return false;
+    }
     if (!mqttClient.connected()) {
         Serial.println("MQTT not connected, cannot subscribe");
         return false;
@@ -201,6 +373,7 @@ bool MQTTManager::subscribe(const char* topic, uint8_t qos) {
     
     bool result = mqttClient.subscribe(topic, qos);
     if (result) {
+        lastOutMs = millis();
         Serial.printf("MQTT Subscribed to: %s\n", topic);
     } else {
         Serial.printf("MQTT Subscribe failed: %s\n", topic);
@@ -210,12 +383,13 @@ bool MQTTManager::subscribe(const char* topic, uint8_t qos) {
 }
 
 bool MQTTManager::unsubscribe(const char* topic) {
-    if (!mqttClient.connected()) {
+    if (!ownsClient() || !mqttClient.connected()) {
         return false;
     }
     
     bool result = mqttClient.unsubscribe(topic);
     if (result) {
+        lastOutMs = millis();
         Serial.printf("MQTT Unsubscribed from: %s\n", topic);
     }
     
@@ -237,8 +411,20 @@ void MQTTManager::setDisconnectCallback(std::function<void()> callback) {
     disconnectCallback = callback;
 }
 
+// Cached by the MQTT task so other tasks never touch the socket
 bool MQTTManager::connected() const {
-    return const_cast<PubSubClient&>(mqttClient).connected();
+    return isConnected;
+}
+
+void MQTTManager::printStats() {
+    float seconds = (millis() - statsSince) / 1000.0f;
+    if (seconds <= 0) seconds = 1;
+    
+    uint32_t wakeups = socketWakeups + outboxWakeups + timeoutWakeups;
+    Serial.printf("Task wakeups: %lu (%.2f/s) - socket %lu, outbox %lu, timeout %lu\n",
+                  wakeups, wakeups / seconds, socketWakeups, outboxWakeups, timeoutWakeups);
+    Serial.printf("Queued publishes: %lu, dropped %lu\n", publishesQueued, publishesDropped);
+    Serial.printf("Keepalive pings: %lu, last packet out %lu ms ago\n", pingsSent, millis() - lastOutMs);
 }
 
 String MQTTManager::getClientId() const {
@@ -456,7 +642,17 @@ void MQTTManager::subscribeToDefaultTopics() {
 // Message Handling
 // ================================
 
+// Data topics are subscribed as "<kind>/+"; also accept them under a prefix ("site/energy/x")
+static bool topicIn(const char* topic, const char* kind) {
+    size_t n = strlen(kind);
+    if (strncmp(topic, kind, n) == 0) return true;
+    const char* at = strstr(topic, kind);
+    return at && at > topic && at[-1] == '/';
+}
+
 void MQTTManager::handleIncomingMessage(char* topic, uint8_t* payload, unsigned int length) {
+    inboundMessageCount++;
+    
     // Convert payload to string
     char message[length + 1];
     memcpy(message, payload, length);
@@ -468,7 +664,7 @@ void MQTTManager::handleIncomingMessage(char* topic, uint8_t* payload, unsigned
     JsonDocument doc;
     if (parseJsonMessage(message, length, doc)) {
         // Handle different topic types
-        if (strstr(topic, "/energy/")) {
+        if (topicIn(topic, "energy/")) {
             if (energyCallback) {
                 energyCallback(doc, String(topic));
             } else {
@@ -478,7 +674,7 @@ void MQTTManager::handleIncomingMessage(char* topic, uint8_t* payload, unsigned
                 Serial.printf("Energy data - Power: %.2f W, Energy: %.2f kWh\n", power, energy);
             }
             
-        } else if (strstr(topic, "/weather/")) {
+        } else if (topicIn(topic, "weather/")) {
             if (weatherCallback) {
                 weatherCallback(doc, String(topic));
             } else {
@@ -488,7 +684,7 @@ void MQTTManager::handleIncomingMessage(char* topic, uint8_t* payload, unsigned
                 Serial.printf("Weather data - Temp: %.1f°C, Humidity: %d%%\n", temp, humidity);
             }
             
-        } else if (strstr(topic, "/house/")) {
+        } else if (topicIn(topic, "house/")) {
             if (houseCallback) {
                 houseCallback(doc, String(topic));
             } else {
@@ -514,6 +710,9 @@ void MQTTManager::handleIncomingMessage(char* topic, uint8_t* payload, unsigned
     if (messageCallback) {
         messageCallback(topic, payload, length);
     }
+    
+    // Let the UI loop pick up whatever the callbacks changed
+    UiScheduler::notify(UI_EVENT_MQTT);
 }
 
 void MQTTManager::handleDeviceCommand(const String& command, const JsonDocument& data) {
@@ -547,6 +746,10 @@ void MQTTManager::publishDeviceStatus() {
     statusDoc["mqtt_connected"] = connected();
     statusDoc["client_id"] = getClientId();
     
+    if (statusCallback) {
+        statusCallback(statusDoc);
+    }
+    
     String statusTopic = getDeviceTopic("status");
     publishJson(statusTopic.c_str(), statusDoc);
     
@@ -568,3 +771,7 @@ void MQTTManager::setWeatherCallback(std::function<void(const JsonDocument&, con
 void MQTTManager::setHouseCallback(std::function<void(const JsonDocument&, const String&)> callback) {
     houseCallback = callback;
 }
+
+void MQTTManager::setStatusCallback(std::function<void(JsonDocument&)> callback) {
+    statusCallback = callback;
+}
@@ -0,0 +1,183 @@
+#include "perf_overlay.h"
+#include "display_manager.h"
+#include "mqtt_manager.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_freertos_hooks.h"
+#include "hal/cpu_hal.h"
+#include <Preferences.h>
+
+// Static member definitions
+lv_obj_t* PerfOverlay::panel = nullptr;
+lv_obj_t* PerfOverlay::label = nullptr;
+lv_timer_t* PerfOverlay::timer = nullptr;
+bool PerfOverlay::enabled = false;
+int64_t PerfOverlay::lastSampleUs = 0;
+uint32_t PerfOverlay::lastMqttCount = 0;
+uint32_t PerfOverlay::lastIdleUs[portNUM_PROCESSORS] = {};
+int64_t PerfOverlay::lastCpuSampleUs = 0;
+volatile uint32_t PerfOverlay::idleUs[portNUM_PROCESSORS] = {};
+volatile int64_t PerfOverlay::waitStartUs[portNUM_PROCESSORS] = {};
+volatile bool PerfOverlay::waitPreempted[portNUM_PROCESSORS] = {};
+bool PerfOverlay::hooksInstalled = false;
+
+void PerfOverlay::begin() {
+    Preferences prefs;
+    prefs.begin("config", true);
+    bool saved = prefs.getBool("perf_overlay", false);
+    prefs.end();
+
+    if (saved) {
+        setEnabled(true);
+    }
+}
+
+void PerfOverlay::setEnabled(bool on) {
+    if (on == enabled) return;
+    enabled = on;
+
+    if (on) {
+        if (!panel) create();
+        lv_obj_clear_flag(panel, LV_OBJ_FLAG_HIDDEN);
+
+        // Start rate measurements from now rather than from the last time we were shown
+        DisplayManager::takeFrameStats();
+        lastSampleUs = esp_timer_get_time();
+        lastMqttCount = mqttManager.getInboundMessageCount();
+        installHooks(true);
+        int unused[portNUM_PROCESSORS];
+        sampleCpuLoad(unused);
+        lv_timer_resume(timer);
+    } else if (panel) {
+        lv_timer_pause(timer);
+        lv_obj_add_flag(panel, LV_OBJ_FLAG_HIDDEN);
+        installHooks(false);
+    }
+
+    Preferences prefs;
+    prefs.begin("config", false);
+    prefs.putBool("perf_overlay", on);
+    prefs.end();
+
+    Serial.printf("Performance overlay %s\n", on ? "enabled" : "disabled");
+}
+
+void PerfOverlay::create() {
+    // Fixed size so text updates never trigger a relayout of anything else
+    panel = lv_obj_create(lv_layer_sys());
+    lv_obj_set_size(panel, 200, 92);
+    lv_obj_align(panel, LV_ALIGN_BOTTOM_MID, 0, -30);
+    lv_obj_clear_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(panel, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_bg_color(panel, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(panel, LV_OPA_70, 0);
+    lv_obj_set_style_border_width(panel, 0, 0);
+    lv_obj_set_style_radius(panel, 8, 0);
+    lv_obj_set_style_pad_all(panel, 6, 0);
+
+    label = lv_label_create(panel);
+    lv_obj_set_width(label, lv_pct(100));
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    lv_label_set_text(label, "");
+
+    timer = lv_timer_create(update, UPDATE_PERIOD_MS, nullptr);
+    lv_timer_pause(timer);
+}
+
+void PerfOverlay::update(lv_timer_t* t) {
+    int64_t nowUs = esp_timer_get_time();
+    float seconds = (nowUs - lastSampleUs) / 1000000.0f;
+    if (seconds <= 0) return;
+    lastSampleUs = nowUs;
+
+    FrameStats frames = DisplayManager::takeFrameStats();
+    float fps = frames.frames / seconds;
+    float renderMs = frames.frames ? frames.renderUs / 1000.0f / frames.frames : 0;
+    float flushMs = frames.frames ? frames.flushUs / 1000.0f / frames.frames : 0;
+
+    uint32_t mqttCount = mqttManager.getInboundMessageCount();
+    float mqttRate = (mqttCount - lastMqttCount) / seconds;
+    lastMqttCount = mqttCount;
+
+    int load[portNUM_PROCESSORS];
+    char cpuText[24];
+    sampleCpuLoad(load);
+#if portNUM_PROCESSORS > 1
+    snprintf(cpuText, sizeof(cpuText), "%d%% / %d%%", load[0], load[1]);
+#else
+    snprintf(cpuText, sizeof(cpuText), "%d%%", load[0]);
+#endif
+
+    char text[160];
+    snprintf(text, sizeof(text),
+             "FPS %.0f  CPU %s\n"
+             "render %.1f ms  flush %.1f ms\n"
+             "int %u KB  psram %u KB\n"
+             "mqtt %.1f msg/s",
+             fps, cpuText, renderMs, flushMs,
+             heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024,
+             heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024,
+             mqttRate);
+
+    // Only invalidate when something visible changed
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+// The stock Arduino build has no FreeRTOS run time stats, so idle time is
+// measured directly: the idle hook halts the core itself (returning false
+// stops IDF doing it again) and times the wait. A task woken by the
+// interrupt that ends the wait runs before the hook reads the clock, so a
+// tick that finds another task on a core mid-wait discards that wait. Work
+// started and finished within one tick still counts as idle, which bounds
+// the error to one tick per wakeup.
+bool IRAM_ATTR PerfOverlay::idleHook() {
+    int cpu = xPortGetCoreID();
+    waitPreempted[cpu] = false;
+    int64_t start = esp_timer_get_time();
+    waitStartUs[cpu] = start;
+    cpu_hal_waiti();
+    int64_t end = esp_timer_get_time();
+    waitStartUs[cpu] = 0;
+    if (!waitPreempted[cpu]) idleUs[cpu] += (uint32_t)(end - start);
+    return false;
+}
+
+void IRAM_ATTR PerfOverlay::tickHook() {
+    int cpu = xPortGetCoreID();
+    if (waitStartUs[cpu] && xTaskGetCurrentTaskHandleForCPU(cpu) != xTaskGetIdleTaskHandleForCPU(cpu)) {
+        waitPreempted[cpu] = true;
+    }
+}
+
+void PerfOverlay::installHooks(bool on) {
+    if (on == hooksInstalled) return;
+    hooksInstalled = on;
+
+    for (int cpu = 0; cpu < portNUM_PROCESSORS; cpu++) {
+        if (on) {
+            esp_register_freertos_idle_hook_for_cpu(idleHook, cpu);
+            esp_register_freertos_tick_hook_for_cpu(tickHook, cpu);
+        } else {
+            esp_deregister_freertos_idle_hook_for_cpu(idleHook, cpu);
+            esp_deregister_freertos_tick_hook_for_cpu(tickHook, cpu);
+        }
+    }
+}
+
+void PerfOverlay::sampleCpuLoad(int loadPercent[portNUM_PROCESSORS]) {
+    int64_t nowUs = esp_timer_get_time();
+    uint32_t elapsed = (uint32_t)(nowUs - lastCpuSampleUs);
+    lastCpuSampleUs = nowUs;
+
+    for (int cpu = 0; cpu < portNUM_PROCESSORS; cpu++) {
+        uint32_t idle = idleUs[cpu];
+        uint32_t idleElapsed = idle - lastIdleUs[cpu];
+        lastIdleUs[cpu] = idle;
+
+        int load = elapsed ? 100 - (int)((uint64_t)idleElapsed * 100 / elapsed) : 0;
+        loadPercent[cpu] = load < 0 ? 0 : (load > 100 ? 100 : load);
+    }
+}
@@ -0,0 +1,183 @@
+#include "redraw_debug.h"
+
+#ifdef DISPLAY_REDRAW_DEBUG
+
+#include "lcd_driver.h"
+#include "display_manager.h"
+#include "app_manager.h"
+
+// Static member definitions
+bool RedrawDebug::enabled = false;
+bool RedrawDebug::logFrames = false;
+bool RedrawDebug::restoring = false;
+lv_timer_t* RedrawDebug::restoreTimer = nullptr;
+uint8_t RedrawDebug::tintIndex = 0;
+uint32_t RedrawDebug::frameAreas = 0;
+uint32_t RedrawDebug::framePixels = 0;
+RedrawDebug::TrackedArea RedrawDebug::tracked[MAX_TRACKED_AREAS];
+RedrawDebug::AppStats RedrawDebug::appStats[MAX_APP_STATS];
+uint32_t RedrawDebug::summaryStartMs = 0;
+uint32_t RedrawDebug::summaryFrames = 0;
+uint64_t RedrawDebug::summaryPixels = 0;
+uint32_t RedrawDebug::summaryMaxMs = 0;
+
+// Tint colours cycle per frame so consecutive redraws of one region are distinguishable
+static const uint32_t TINT_COLORS[] = { 0xFF0000, 0x00FF00, 0x0000FF, 0xFF00FF };
+static const int TINT_COLOR_COUNT = sizeof(TINT_COLORS) / sizeof(TINT_COLORS[0]);
+
+void RedrawDebug::setEnabled(bool on) {
+    enabled = on;
+    if (!on) {
+        // Leave the tints to be restored by the timer, but stop adding new ones
+        printStats();
+    } else {
+        memset(appStats, 0, sizeof(appStats));
+        summaryStartMs = millis();
+        summaryFrames = 0;
+        summaryPixels = 0;
+        summaryMaxMs = 0;
+        if (!restoreTimer) {
+            restoreTimer = lv_timer_create(restoreExpired, RESTORE_PERIOD_MS, nullptr);
+            lv_timer_pause(restoreTimer);
+        }
+    }
+    Serial.printf("Redraw debug %s\n", on ? "enabled" : "disabled");
+}
+
+void RedrawDebug::setFrameLogging(bool on) {
+    logFrames = on;
+    Serial.printf("Redraw logging %s\n", on ? "every frame" : "once per second");
+}
+
+void RedrawDebug::printStats() {
+    Serial.println("\n=== REDRAW STATS ===");
+    const uint32_t screenPx = EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES;
+    for (int i = 0; i < MAX_APP_STATS && appStats[i].name; i++) {
+        const AppStats& s = appStats[i];
+        uint32_t avg = s.frames ? (uint32_t)(s.pixels / s.frames) : 0;
+        Serial.printf("%-10s frames: %lu  avg: %lu px/frame (%.1f%% of screen)\n",
+                      s.name, s.frames, avg, 100.0 * avg / screenPx);
+    }
+    Serial.println("====================\n");
+}
+
+void RedrawDebug::flush_cb(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
+    if (enabled && !restoring) {
+        frameAreas++;
+        framePixels += lv_area_get_size(area);
+        tintArea(area, color_p);
+        trackArea(area);
+    }
+    LcdDriver::display_flush_cb(disp, area, color_p);
+}
+
+void RedrawDebug::monitor_cb(lv_disp_drv_t *disp, uint32_t time, uint32_t px) {
+    if (enabled && !restoring) {
+        recordFrame(time, px);
+    }
+    frameAreas = 0;
+    framePixels = 0;
+    tintIndex = (tintIndex + 1) % TINT_COLOR_COUNT;
+}
+
+// LVGL timer, only running while tinted areas are on screen - a static
+// screen produces no frames, so the tints can't be aged by monitor_cb
+void RedrawDebug::restoreExpired(lv_timer_t* timer) {
+    // No rendering while the draw buffers are released; restore after resume
+    if (DisplayManager::isRenderingSuspended()) return;
+
+    lv_disp_t* disp = lv_disp_get_default();
+    uint32_t now = millis();
+    bool expired = false;
+    bool pending = false;
+    for (int i = 0; i < MAX_TRACKED_AREAS; i++) {
+        if (!tracked[i].active) continue;
+        if ((int32_t)(now - tracked[i].expiresMs) >= 0) {
+            if (disp) _lv_inv_area(disp, &tracked[i].area);
+            tracked[i].active = false;
+            expired = true;
+        } else {
+            pending = true;
+        }
+    }
+    if (!pending) lv_timer_pause(timer);
+    if (!expired || !disp) return;
+
+    // Redraw the expired areas untinted and keep them out of the statistics
+    restoring = true;
+    lv_refr_now(disp);
+    restoring = false;
+}
+
+void RedrawDebug::trackArea(const lv_area_t* area) {
+    int slot = -1;
+    for (int i = 0; i < MAX_TRACKED_AREAS; i++) {
+        if (!tracked[i].active) { slot = i; break; }
+    }
+    if (slot < 0) {
+        // Out of slots - reuse the entry closest to expiring; the next refresh repaints it anyway
+        slot = 0;
+        for (int i = 1; i < MAX_TRACKED_AREAS; i++) {
+            if ((int32_t)(tracked[i].expiresMs - tracked[slot].expiresMs) < 0) slot = i;
+        }
+    }
+    lv_area_copy(&tracked[slot].area, area);
+    tracked[slot].expiresMs = millis() + HOLD_MS;
+    tracked[slot].active = true;
+    if (restoreTimer) lv_timer_resume(restoreTimer);
+}
+
+void RedrawDebug::tintArea(const lv_area_t* area, lv_color_t* color_p) {
+    const lv_color_t tint = lv_color_hex(TINT_COLORS[tintIndex]);
+    const int32_t w = lv_area_get_width(area);
+    const int32_t h = lv_area_get_height(area);
+
+    for (int32_t y = 0; y < h; y++) {
+        lv_color_t* row = color_p + y * w;
+        bool edgeRow = (y < 2) || (y >= h - 2);
+        for (int32_t x = 0; x < w; x++) {
+            if (edgeRow || x < 2 || x >= w - 2) {
+                row[x] = tint;  // Solid outline
+            } else {
+                row[x] = lv_color_mix(tint, row[x], LV_OPA_30);
+            }
+        }
+    }
+}
+
+void RedrawDebug::recordFrame(uint32_t timeMs, uint32_t px) {
+    BaseApp* app = appManager.getCurrentApp();
+    const char* name = app ? app->getName() : "(none)";
+
+    for (int i = 0; i < MAX_APP_STATS; i++) {
+        if (!appStats[i].name || appStats[i].name == name) {
+            appStats[i].name = name;
+            appStats[i].frames++;
+            appStats[i].pixels += px;
+            break;
+        }
+    }
+
+    const uint32_t screenPx = EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES;
+    if (logFrames) {
+        Serial.printf("[redraw] %s: %lu px (%.1f%%) in %lu areas, %lu ms\n",
+                      name, px, 100.0 * px / screenPx, frameAreas, timeMs);
+        return;
+    }
+
+    summaryFrames++;
+    summaryPixels += px;
+    if (timeMs > summaryMaxMs) summaryMaxMs = timeMs;
+    uint32_t now = millis();
+    if (now - summaryStartMs < SUMMARY_PERIOD_MS) return;
+
+    uint32_t avg = (uint32_t)(summaryPixels / summaryFrames);
+    Serial.printf("[redraw] %s: %lu frames in %lu ms, avg %lu px (%.1f%%), slowest %lu ms\n",
+                  name, summaryFrames, now - summaryStartMs, avg, 100.0 * avg / screenPx, summaryMaxMs);
+    summaryStartMs = now;
+    summaryFrames = 0;
+    summaryPixels = 0;
+    summaryMaxMs = 0;
+}
+
+#endif // DISPLAY_REDRAW_DEBUG
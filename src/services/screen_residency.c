@@ -0,0 +1,45 @@
+/*
+ * Residency policy for app screens.
+ */
+
+#include "screen_residency.h"
+
+int screen_residency_count(const screen_slot_t *slots, int count)
+{
+    int built = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (slots[i].built)
+            built++;
+    }
+    return built;
+}
+
+int screen_residency_pick(const screen_slot_t *slots, int count, int keep, int also_keep)
+{
+    int victim = -1;
+    for (int i = 0; i < count; i++)
+    {
+        if (i == keep || i == also_keep || !slots[i].built || !slots[i].evictable)
+            continue;
+        if (victim < 0 || slots[i].last_used < slots[victim].last_used)
+            victim = i;
+    }
+    return victim;
+}
+
+bool screen_residency_trim(screen_slot_t *slots, int count, int limit, int keep, int also_keep,
+                           screen_evict_fn evict, void *ctx)
+{
+    while (screen_residency_count(slots, count) > limit)
+    {
+        int victim = screen_residency_pick(slots, count, keep, also_keep);
+        if (victim < 0)
+            return false;
+
+        slots[victim].evictable = false;
+        if (evict(victim, ctx))
+            slots[victim].built = false;
+    }
+    return true;
+}
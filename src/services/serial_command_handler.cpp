@@ -1,13 +1,45 @@
 #include "serial_command_handler.h"
+#include "redraw_debug.h"
+#include "always_on_display.h"
+#include "ui_scheduler.h"
+#include "perf_overlay.h"
+#include "app_manager.h"
+#include "layout_loader.h"
+#include "widget_pool.h"
+#include "ui_update_queue.h"
+#include "input_frame.h"
+#include "encoder_manager.h"
+#include "knob_input.h"
+#include "knob_trace.h"
+#include "touch_trace.h"
+#include "display_manager.h"
+#include "esp_heap_caps.h"
 
 // Static member definitions
 bool SerialCommandHandler::enabled = true;
 unsigned long SerialCommandHandler::lastCommandTime = 0;
 
+// Wake the UI loop as soon as a command byte arrives instead of at its next deadline
+#if ARDUINO_USB_MODE && ARDUINO_USB_CDC_ON_BOOT
+static void onSerialReceive(void* arg, esp_event_base_t base, int32_t id, void* data) {
+    UiScheduler::notify(UI_EVENT_SERIAL);
+}
+#else
+static void onSerialReceive() {
+    UiScheduler::notify(UI_EVENT_SERIAL);
+}
+#endif
+
 void SerialCommandHandler::begin(bool enableCommands) {
     enabled = enableCommands;
     lastCommandTime = millis();
     
+#if ARDUINO_USB_MODE && ARDUINO_USB_CDC_ON_BOOT
+    Serial.onEvent(ARDUINO_HW_CDC_RX_EVENT, onSerialReceive);
+#else
+    Serial.onReceive(onSerialReceive);
+#endif
+    
     if (enabled) {
         Serial.println("\n=== ESP32-S3 Knob Command Interface ===");
         Serial.println("Type 'help' for available commands");
@@ -118,6 +150,114 @@ void SerialCommandHandler::executeCommand(const String& command) {
         return;
     }
     
+    if (command == "sched") {
+        UiScheduler::printStats();
+        return;
+    }
+    
+    if (command == "sched_reset") {
+        UiScheduler::resetStats();
+        Serial.println("Scheduler statistics reset");
+        return;
+    }
+    
+    if (command == "uiq") {
+        UiUpdateQueue::printStats();
+        return;
+    }
+    
+    if (command == "uiq_reset") {
+        UiUpdateQueue::resetStats();
+        Serial.println("UI update queue statistics reset");
+        return;
+    }
+    
+    if (command == "input") {
+        InputFrame::printStats();
+        return;
+    }
+    
+    if (command == "input_reset") {
+        InputFrame::resetStats();
+        Serial.println("Input frame statistics reset");
+        return;
+    }
+    
+    if (command == "touch") {
+        LcdDriver::printTouchStats();
+        return;
+    }
+    
+    if (command == "touch_reset") {
+        LcdDriver::resetTouchStats();
+        Serial.println("Touch statistics reset");
+        return;
+    }
+    
+    if (command == "touch trace start") {
+        if (TouchTrace::start()) {
+            Serial.println("Capturing touch samples - make the gestures, then: touch trace stop");
+        }
+        return;
+    }
+    
+    if (command == "touch trace stop") {
+        TouchTrace::stop();
+        TouchTrace::printStatus();
+        return;
+    }
+    
+    if (command == "touch trace dump") {
+        TouchTrace::dump();
+        return;
+    }
+    
+    if (command == "touch trace") {
+        TouchTrace::printStatus();
+        return;
+    }
+    
+    if (command.startsWith("knob")) {
+        processKnobCommands(command);
+        return;
+    }
+    
+    // App commands
+    if (command.startsWith("appmem")) {
+        processAppMemoryCommands(command);
+        return;
+    }
+    
+    if (command.startsWith("apps")) {
+        processAppCommands(command);
+        return;
+    }
+    
+    // Widget pool commands
+    if (command.startsWith("pool")) {
+        processPoolCommands(command);
+        return;
+    }
+    
+    // Layout commands
+    if (command.startsWith("layout")) {
+        processLayoutCommands(command);
+        return;
+    }
+    
+    // Display commands
+    if (command.startsWith("aod") || command.startsWith("perf")) {
+        processDisplayCommands(command);
+        return;
+    }
+    
+#ifdef DISPLAY_REDRAW_DEBUG
+    if (command.startsWith("redraw")) {
+        processRedrawCommands(command);
+        return;
+    }
+#endif
+    
     // Unknown command
     Serial.printf("Unknown command: %s\n", command.c_str());
     Serial.println("Type 'help' for available commands");
@@ -165,6 +305,7 @@ void SerialCommandHandler::processMQTTCommands(const String& command) {
             Serial.printf("Server: %s:%d\n", mqttManager.getServer().c_str(), mqttManager.getPort());
             Serial.printf("Client ID: %s\n", mqttManager.getClientId().c_str());
         }
+        mqttManager.printStats();
         Serial.println("==================");
         
     } else {
@@ -204,6 +345,300 @@ void SerialCommandHandler::processSystemCommands(const String& command) {
     }
 }
 
+void SerialCommandHandler::processDisplayCommands(const String& command) {
+    if (command == "aod on") {
+        AlwaysOnDisplay::enter();
+        
+    } else if (command == "aod off") {
+        AlwaysOnDisplay::exit();
+        
+    } else if (command == "aod status" || command == "aod") {
+        AlwaysOnDisplay::printStats();
+        
+    } else if (command == "perf on") {
+        PerfOverlay::setEnabled(true);
+        
+    } else if (command == "perf off") {
+        PerfOverlay::setEnabled(false);
+        
+    } else {
+        Serial.println("Display commands:");
+        Serial.println("  aod on       - Enter low-power always-on clock");
+        Serial.println("  aod off      - Return to the full UI");
+        Serial.println("  aod status   - Show RAM released and bus bytes per minute");
+        Serial.println("  perf on|off  - Show or hide the performance overlay");
+    }
+}
+
+#ifdef DISPLAY_REDRAW_DEBUG
+void SerialCommandHandler::processRedrawCommands(const String& command) {
+    if (command == "redraw on") {
+        RedrawDebug::setEnabled(true);
+        
+    } else if (command == "redraw off") {
+        RedrawDebug::setEnabled(false);
+        
+    } else if (command == "redraw stats") {
+        RedrawDebug::printStats();
+        
+    } else if (command == "redraw log on" || command == "redraw log off") {
+        RedrawDebug::setFrameLogging(command == "redraw log on");
+        
+    } else {
+        Serial.println("Redraw debug commands:");
+        Serial.println("  redraw on     - Tint flushed areas and log redraw area once per second");
+        Serial.println("  redraw off    - Stop and print per-app summary");
+        Serial.println("  redraw stats  - Print per-app redraw summary");
+        Serial.println("  redraw log on|off - Log every frame instead of a summary per second");
+    }
+}
+#endif
+
+void SerialCommandHandler::processAppCommands(const String& command) {
+    if (command == "apps") {
+        appManager.printStatus();
+    } else if (command == "apps reset") {
+        appManager.resetStats();
+        Serial.println("App statistics reset");
+    } else if (command.startsWith("apps budget ")) {
+        int screens = command.substring(12).toInt();
+        if (screens <= 0) {
+            Serial.println("Budget must be at least 1 screen");
+            return;
+        }
+        appManager.setResidentScreenBudget(screens);
+        Serial.printf("Resident screen budget set to %d\n", appManager.getResidentScreenBudget());
+    } else if (command.startsWith("apps nav ")) {
+        appManager.setNavigationWindow(command.substring(9).toInt());
+        Serial.printf("Navigation window set to %lu ms\n", appManager.getNavigationWindow());
+    } else if (command == "apps prefetch on" || command == "apps prefetch off") {
+        appManager.setPrefetchEnabled(command.endsWith("on"));
+        Serial.printf("Prefetch %s\n", appManager.isPrefetchEnabled() ? "enabled" : "disabled");
+    } else if (command.startsWith("apps prefetch ")) {
+        appManager.setPrefetchBudget(command.substring(14).toInt());
+        Serial.printf("Prefetch budget set to %u bytes\n", (unsigned)appManager.getPrefetchBudget());
+    } else if (command.startsWith("apps soak")) {
+        int cycles = command.length() > 10 ? command.substring(10).toInt() : 0;
+        runAppSoak(cycles > 0 ? cycles : 5000);
+    } else {
+        Serial.println("App commands:");
+        Serial.println("  apps          - List apps, residency and per-app CPU time");
+        Serial.println("  apps reset    - Reset per-app CPU statistics");
+        Serial.println("  apps budget N - Keep at most N app screens built");
+        Serial.println("  apps nav MS   - Coalesce detents closer than MS (0 = off)");
+        Serial.println("  apps prefetch on|off|BYTES - Idle prefetch of neighbour screens");
+        Serial.println("  apps soak [N] - Switch apps N times and check for leaks");
+    }
+}
+
+void SerialCommandHandler::processAppMemoryCommands(const String& command) {
+    if (command == "appmem") {
+        appManager.printMemory();
+    } else if (command.startsWith("appmem limit ")) {
+        // appmem limit <app> <bytes> [objects]
+        String args = command.substring(13);
+        int first = args.indexOf(' ');
+        if (first < 0) {
+            Serial.println("Usage: appmem limit <app> <bytes> [objects]");
+            return;
+        }
+        String name = args.substring(0, first);
+        String rest = args.substring(first + 1);
+        int second = rest.indexOf(' ');
+        size_t bytes = rest.substring(0, second < 0 ? rest.length() : second).toInt();
+        uint16_t objects = second < 0 ? AppManager::DEFAULT_WARN_OBJECTS : rest.substring(second + 1).toInt();
+
+        if (appManager.setMemoryLimit(name.c_str(), bytes, objects)) {
+            Serial.printf("Limit for %s set to %u bytes / %u objects\n", name.c_str(), (unsigned)bytes, objects);
+        } else {
+            Serial.printf("Unknown app: %s\n", name.c_str());
+        }
+    } else {
+        Serial.println("App memory commands:");
+        Serial.println("  appmem        - Per-app LVGL memory, objects and styles");
+        Serial.println("  appmem limit <app> <bytes> [objects] - Warning thresholds (0 = none)");
+    }
+}
+
+void SerialCommandHandler::processKnobCommands(const String& command) {
+    if (command == "knob") {
+        EncoderManager::printStatus();
+        KnobInput::printStatus();
+    } else if (command == "knob mode nav" || command == "knob mode focus") {
+        bool focus = command == "knob mode focus";
+        if (KnobInput::setMode(focus ? KnobInput::Mode::Focus : KnobInput::Mode::Navigate)) {
+            Serial.printf("Knob now %s\n", focus ? "drives the app's widgets" : "switches apps");
+        } else {
+            Serial.println("This app has no widgets for the knob");
+        }
+    } else if (command == "knob press") {
+        KnobInput::press();
+    } else if (command == "knob trace start") {
+        if (KnobTrace::start()) {
+            Serial.println("Capturing knob edges - turn the knob, then: knob trace stop");
+        }
+    } else if (command == "knob trace stop") {
+        KnobTrace::stop();
+        KnobTrace::printStatus();
+    } else if (command == "knob trace dump") {
+        KnobTrace::dump();
+    } else if (command == "knob trace") {
+        KnobTrace::printStatus();
+    } else if (command.startsWith("knob accel ")) {
+        // knob accel <start> <full> <max>
+        int start = 0, full = 0, max = 0;
+        if (sscanf(command.c_str() + 11, "%d %d %d", &start, &full, &max) == 3 &&
+            start >= 0 && max <= 255 && EncoderManager::setAccelCurve(start, full, max)) {
+            Serial.printf("Acceleration: x1 up to %d detents/s, x%d from %d detents/s\n", start, max, full);
+        } else {
+            Serial.println("Usage: knob accel <start> <full> <max> (full > start, max >= 1)");
+        }
+    } else if (command == "knob bench") {
+        EncoderManager::runTickBenchmark();
+    } else if (command == "knob sampling batched" || command == "knob sampling pins") {
+        bool batched = command == "knob sampling batched";
+        iot_knob_set_sampling(batched ? KNOB_SAMPLING_BATCHED : KNOB_SAMPLING_PER_PIN);
+        Serial.printf("Timer backend now reads %s\n", batched ? "one input register per tick" : "each pin separately");
+    } else if (command == "knob reset") {
+        EncoderManager::resetStats();
+        Serial.println("Knob event statistics reset");
+    } else {
+        Serial.println("Knob commands:");
+        Serial.println("  knob          - Backend, counts, speed and rejected bounces");
+        Serial.println("  knob accel <start> <full> <max> - Acceleration curve in detents/s");
+        Serial.println("  knob bench    - Timer tick cost against knob count");
+        Serial.println("  knob sampling batched|pins - Timer backend pin reads");
+        Serial.println("  knob reset    - Reset event ring statistics");
+        Serial.println("  knob mode nav|focus - Knob switches apps or drives the app's widgets");
+        Serial.println("  knob press    - Encoder key click (Focus mode)");
+        Serial.println("  knob trace start|stop - Capture raw A/B edges to PSRAM");
+        Serial.println("  knob trace dump - Print the capture for tools/knob_replay");
+    }
+}
+
+void SerialCommandHandler::processPoolCommands(const String& command) {
+    if (command == "pool") {
+        WidgetPool::printStats();
+    } else if (command == "pool on" || command == "pool off") {
+        WidgetPool::setEnabled(command == "pool on");
+        WidgetPool::resetStats();
+        appManager.resetStats();
+        Serial.printf("Widget pooling %s, statistics reset\n", WidgetPool::isEnabled() ? "enabled" : "disabled");
+    } else {
+        Serial.println("Widget pool commands:");
+        Serial.println("  pool          - Show widget pool statistics");
+        Serial.println("  pool on|off   - Toggle pooling (compare 'apps' blocks per switch)");
+    }
+}
+
+void SerialCommandHandler::processLayoutCommands(const String& command) {
+    if (command == "layout") {
+        LayoutLoader::printStatus();
+    } else if (command.startsWith("layout bench")) {
+        int iterations = command.length() > 13 ? command.substring(13).toInt() : 0;
+        runLayoutBench(iterations > 0 ? iterations : 50);
+    } else {
+        Serial.println("Layout commands:");
+        Serial.println("  layout           - Show installed screen layouts");
+        Serial.println("  layout bench [N] - Time layout vs built-in screen construction");
+    }
+}
+
+void SerialCommandHandler::runLayoutBench(int iterations) {
+    Serial.printf("\n=== LAYOUT BENCH (%d builds per screen) ===\n", iterations);
+    Serial.println("  app         built-in us   layout us");
+
+    bool wasEnabled = LayoutLoader::isEnabled();
+    for (int i = 0; i < appManager.getAppCount(); i++) {
+        BaseApp* app = appManager.getApp(i);
+        uint32_t elapsed[2] = {};
+
+        // Pass 0 forces the imperative fallback, pass 1 uses the installed layout
+        for (int pass = 0; pass < 2; pass++) {
+            LayoutLoader::setEnabled(pass == 1);
+            lv_obj_t* warm = app->createScreen();  // Warm-up: first layout use reads the file
+            WidgetPool::reclaim(warm);
+            lv_obj_del(warm);
+            for (int n = 0; n < iterations; n++) {
+                uint32_t start = micros();
+                lv_obj_t* scr = app->createScreen();
+                elapsed[pass] += micros() - start;
+                WidgetPool::reclaim(scr);
+                lv_obj_del(scr);
+            }
+        }
+
+        Serial.printf("  %-10s %12.1f %11.1f\n", app->getName(),
+                      (float)elapsed[0] / iterations, (float)elapsed[1] / iterations);
+    }
+    LayoutLoader::setEnabled(wasEnabled);
+    Serial.println("Layout column equals built-in when no layout is installed (see 'layout')");
+    Serial.println("==========================================\n");
+}
+
+void SerialCommandHandler::runAppSoak(int cycles) {
+    const int appCount = appManager.getAppCount();
+    if (appCount < 2) {
+        Serial.println("Soak needs at least two registered apps");
+        return;
+    }
+
+    // One full forward sweep leaves a deterministic set of resident screens,
+    // so measure after a sweep and compare after another one
+    auto sweep = [appCount]() {
+        for (int i = 0; i < appCount; i++) {
+            appManager.switchBy(1);
+            DisplayManager::handleLVGLTasks();
+        }
+    };
+
+    Serial.printf("\n=== APP SOAK (%d switches) ===\n", cycles);
+    sweep();
+
+    lv_mem_monitor_t lvBefore;
+    lv_mem_monitor(&lvBefore);
+    size_t heapBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    int indexBefore = appManager.getCurrentIndex();
+    uint32_t switchesBefore = appManager.getSwitchCount();
+    uint32_t blocksBefore = appManager.getBuildBlocks();
+
+    for (int i = 0; i < cycles; i++) {
+        // Mostly forward with some back-steps to exercise both directions
+        appManager.switchBy((i % 7) < 4 ? 1 : -1);
+        DisplayManager::handleLVGLTasks();
+        if ((i & 63) == 0) vTaskDelay(1);  // Let network tasks run
+    }
+
+    // Return to the same app, then sweep again
+    while (appManager.getCurrentIndex() != indexBefore) {
+        appManager.switchBy(1);
+    }
+    sweep();
+
+    lv_mem_monitor_t lvAfter;
+    lv_mem_monitor(&lvAfter);
+    size_t heapAfter = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    int heapDrift = (int)heapBefore - (int)heapAfter;
+    int lvDrift = (int)lvBefore.free_size - (int)lvAfter.free_size;
+
+    bool countOk = appManager.getAppCount() == appCount;
+    bool lvOk = lvDrift == 0;
+    bool heapOk = heapDrift <= SOAK_HEAP_TOLERANCE;  // Other tasks allocate concurrently
+
+    Serial.printf("App count:   %d -> %d %s\n", appCount, appManager.getAppCount(), countOk ? "OK" : "FAIL");
+    Serial.printf("LVGL memory: %u -> %u free (%+d) %s\n",
+                  (unsigned)lvBefore.free_size, (unsigned)lvAfter.free_size, -lvDrift, lvOk ? "OK" : "FAIL");
+    Serial.printf("Heap:        %u -> %u free (%+d) %s\n",
+                  (unsigned)heapBefore, (unsigned)heapAfter, -heapDrift, heapOk ? "OK" : "FAIL");
+    // The figure to compare between "pool on" and "pool off"
+    uint32_t soakSwitches = appManager.getSwitchCount() - switchesBefore;
+    Serial.printf("Builds:      %.1f LVGL blocks allocated per switch (pool %s)\n",
+                  soakSwitches ? (float)(appManager.getBuildBlocks() - blocksBefore) / soakSwitches : 0.0f,
+                  WidgetPool::isEnabled() ? "on" : "off");
+    Serial.printf("Result: %s\n", (countOk && lvOk && heapOk) ? "PASS" : "FAIL");
+    Serial.println("============================\n");
+}
+
 void SerialCommandHandler::printHelp() {
     Serial.println("\n=== ESP32-S3 Knob Commands ===");
     Serial.println("SYSTEM:");
@@ -218,6 +653,38 @@ void SerialCommandHandler::printHelp() {
     Serial.println("  reset_wifi    - Reset WiFi configuration");
     Serial.println("  wifi_status   - Show WiFi status");
     Serial.println("");
+    Serial.println("DISPLAY:");
+    Serial.println("  aod on|off    - Low-power always-on clock");
+    Serial.println("  aod status    - Show always-on statistics");
+    Serial.println("  perf on|off   - Performance overlay");
+    Serial.println("");
+    Serial.println("APPS:");
+    Serial.println("  apps          - List apps, residency and per-app CPU time");
+    Serial.println("  apps reset    - Reset per-app CPU statistics");
+    Serial.println("  apps budget N - Keep at most N app screens built");
+    Serial.println("  apps nav MS   - Coalesce detents closer than MS (0 = off)");
+    Serial.println("  apps prefetch on|off|BYTES - Idle prefetch of neighbour screens");
+    Serial.println("  apps soak [N] - Switch apps N times and check for leaks");
+    Serial.println("  appmem        - Per-app LVGL memory, objects and styles");
+    Serial.println("  appmem limit <app> <bytes> [objects] - Warning thresholds (0 = none)");
+    Serial.println("  pool          - Show widget pool statistics");
+    Serial.println("  pool on|off   - Toggle pooling (compare 'apps' blocks per switch)");
+    Serial.println("");
+    Serial.println("LAYOUTS:");
+    Serial.println("  layout           - Show installed screen layouts");
+    Serial.println("  layout bench [N] - Time layout vs built-in screen construction");
+    Serial.println("");
+    Serial.println("KNOB:");
+    Serial.println("  knob          - Backend, counts, speed and rejected bounces");
+    Serial.println("  knob accel <start> <full> <max> - Acceleration curve in detents/s");
+    Serial.println("  knob bench    - Timer tick cost against knob count");
+    Serial.println("  knob sampling batched|pins - Timer backend pin reads");
+    Serial.println("  knob reset    - Reset event ring statistics");
+    Serial.println("  knob mode nav|focus - Knob switches apps or drives the app's widgets");
+    Serial.println("  knob press    - Encoder key click (Focus mode)");
+    Serial.println("  knob trace start|stop - Capture raw A/B edges to PSRAM");
+    Serial.println("  knob trace dump - Print the capture for tools/knob_replay");
+    Serial.println("");
     Serial.println("MQTT:");
     Serial.println("  reset_mqtt    - Reset MQTT configuration");
     Serial.println("  mqtt_status   - Show MQTT status");
@@ -225,6 +692,19 @@ void SerialCommandHandler::printHelp() {
     Serial.println("DEVELOPMENT:");
     Serial.println("  memory        - Show memory usage");
     Serial.println("  tasks         - Show FreeRTOS task info");
+    Serial.println("  sched         - Show UI wakeups and input latency");
+    Serial.println("  sched_reset   - Reset UI scheduler statistics");
+    Serial.println("  uiq           - Show cross-task widget update queue statistics");
+    Serial.println("  uiq_reset     - Reset widget update queue statistics");
+    Serial.println("  input         - Show per-frame input snapshot statistics");
+    Serial.println("  input_reset   - Reset input snapshot statistics");
+    Serial.println("  touch         - Show touch controller I2C statistics");
+    Serial.println("  touch_reset   - Reset touch statistics");
+    Serial.println("  touch trace start|stop - Capture touch samples to PSRAM");
+    Serial.println("  touch trace dump - Print the capture for tools/touch_replay");
+#ifdef DISPLAY_REDRAW_DEBUG
+    Serial.println("  redraw on|off - Outline redrawn regions (debug build)");
+#endif
     Serial.println("");
     Serial.println("Commands auto-disable after 30s of inactivity for security.");
     Serial.println("===============================\n");
@@ -284,6 +764,11 @@ void SerialCommandHandler::printMemoryInfo() {
     float fragmentation = 100.0 * (1.0 - (float)ESP.getMaxAllocHeap() / ESP.getFreeHeap());
     Serial.printf("Heap Fragmentation: %.1f%%\n", fragmentation);
     
+    lv_mem_monitor_t lvgl;
+    lv_mem_monitor(&lvgl);
+    Serial.printf("LVGL Pool: %u / %u bytes used (see 'appmem' for per-app usage)\n",
+                  (unsigned)(lvgl.total_size - lvgl.free_size), (unsigned)lvgl.total_size);
+    
     Serial.println("=========================\n");
 }
 
@@ -0,0 +1,140 @@
+#include "ui_scheduler.h"
+#include "display_manager.h"
+#include "app_manager.h"
+#include "ui_update_queue.h"
+#include "knob_input.h"
+#include "always_on_display.h"
+#include "esp_timer.h"
+
+// Static member definitions
+TaskHandle_t UiScheduler::uiTask = nullptr;
+uint32_t UiScheduler::wakeups = 0;
+uint32_t UiScheduler::timeoutWakeups = 0;
+uint32_t UiScheduler::lvglDeadlines = 0;
+uint32_t UiScheduler::appDeadlines = 0;
+uint32_t UiScheduler::idleDeadlines = 0;
+uint64_t UiScheduler::sleptUs = 0;
+uint32_t UiScheduler::eventWakeups[UI_EVENT_COUNT] = {};
+volatile int64_t UiScheduler::inputPendingSince = 0;
+uint32_t UiScheduler::inputLatencySamples = 0;
+uint64_t UiScheduler::inputLatencyTotalUs = 0;
+uint32_t UiScheduler::inputLatencyMaxUs = 0;
+unsigned long UiScheduler::statsSince = 0;
+
+static const char* EVENT_NAMES[UI_EVENT_COUNT] = { "input", "mqtt", "flush", "request", "serial" };
+
+void UiScheduler::begin() {
+    uiTask = xTaskGetCurrentTaskHandle();
+    resetStats();
+    Serial.println("UI scheduler started");
+}
+
+void UiScheduler::runOnce() {
+    // Feed buffered knob input to LVGL, give the active app its input
+    // snapshot and apply widget updates posted by other tasks, then render
+    // them all in this pass
+    KnobInput::service();
+    appManager.dispatchInput();
+    UiUpdateQueue::drain();
+    AlwaysOnDisplay::service();
+
+    // Run everything that is due; LVGL and the active app say when they are due next
+    uint32_t lvglMs = DisplayManager::handleLVGLTasks();
+    uint32_t appMs = appManager.update();
+    uint32_t nextMs = appMs < lvglMs ? appMs : lvglMs;
+
+    if (nextMs < EXAMPLE_LVGL_TASK_MIN_DELAY_MS) nextMs = EXAMPLE_LVGL_TASK_MIN_DELAY_MS;
+    if (nextMs > EXAMPLE_LVGL_TASK_MAX_DELAY_MS) nextMs = EXAMPLE_LVGL_TASK_MAX_DELAY_MS;
+
+    uint32_t events = 0;
+    int64_t sleepStart = esp_timer_get_time();
+    BaseType_t notified = xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(nextMs));
+    sleptUs += esp_timer_get_time() - sleepStart;
+
+    wakeups++;
+    if (notified != pdTRUE) {
+        timeoutWakeups++;
+        if (nextMs == EXAMPLE_LVGL_TASK_MAX_DELAY_MS) idleDeadlines++;
+        else if (lvglMs <= appMs) lvglDeadlines++;
+        else appDeadlines++;
+        return;
+    }
+
+    for (int i = 0; i < UI_EVENT_COUNT; i++) {
+        if (events & (1u << i)) eventWakeups[i]++;
+    }
+
+    if (events & UI_EVENT_INPUT) {
+        int64_t since = inputPendingSince;
+        inputPendingSince = 0;
+        if (since) {
+            uint32_t latency = (uint32_t)(esp_timer_get_time() - since);
+            inputLatencyTotalUs += latency;
+            inputLatencySamples++;
+            if (latency > inputLatencyMaxUs) inputLatencyMaxUs = latency;
+        }
+    }
+}
+
+void UiScheduler::notify(uint32_t events) {
+    if (!uiTask) return;
+    if ((events & UI_EVENT_INPUT) && !inputPendingSince) {
+        inputPendingSince = esp_timer_get_time();
+    }
+    xTaskNotify(uiTask, events, eSetBits);
+}
+
+bool UiScheduler::notifyFromISR(uint32_t events) {
+    if (!uiTask) return false;
+    if ((events & UI_EVENT_INPUT) && !inputPendingSince) {
+        inputPendingSince = esp_timer_get_time();
+    }
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(uiTask, events, eSetBits, &woken);
+    return woken == pdTRUE;
+}
+
+void UiScheduler::printStats() {
+    float seconds = (millis() - statsSince) / 1000.0f;
+    if (seconds <= 0) seconds = 1;
+
+    Serial.println("\n=== UI SCHEDULER ===");
+    Serial.printf("Wakeups: %lu (%.1f/s, 10 ms polling would be 100/s)\n", wakeups, wakeups / seconds);
+    Serial.printf("  timer deadline: %lu (lvgl %lu, app %lu, idle cap %lu)\n",
+                  timeoutWakeups, lvglDeadlines, appDeadlines, idleDeadlines);
+    for (int i = 0; i < UI_EVENT_COUNT; i++) {
+        Serial.printf("  %-14s %lu\n", EVENT_NAMES[i], eventWakeups[i]);
+    }
+    if (inputLatencySamples) {
+        Serial.printf("Input latency: avg %lu us, max %lu us (%lu samples)\n",
+                      (uint32_t)(inputLatencyTotalUs / inputLatencySamples), inputLatencyMaxUs, inputLatencySamples);
+    } else {
+        Serial.println("Input latency: no samples");
+    }
+    Serial.printf("Asleep: %.1f%% of the time, avg %lu us per wait\n",
+                  sleptUs / (seconds * 10000.0f), wakeups ? (uint32_t)(sleptUs / wakeups) : 0);
+    Serial.println("====================\n");
+}
+
+void UiScheduler::resetStats() {
+    wakeups = 0;
+    timeoutWakeups = 0;
+    lvglDeadlines = 0;
+    appDeadlines = 0;
+    idleDeadlines = 0;
+    sleptUs = 0;
+    memset(eventWakeups, 0, sizeof(eventWakeups));
+    inputLatencySamples = 0;
+    inputLatencyTotalUs = 0;
+    inputLatencyMaxUs = 0;
+    statsSince = millis();
+}
+
+// C entry points
+extern "C" void ui_scheduler_notify(uint32_t events) {
+    UiScheduler::notify(events);
+}
+
+extern "C" bool ui_scheduler_notify_from_isr(uint32_t events) {
+    return UiScheduler::notifyFromISR(events);
+}
@@ -0,0 +1,66 @@
+#include "ui_styles.h"
+
+// Static member definitions
+bool UiStyles::initialized = false;
+lv_style_t UiStyles::titleStyle;
+lv_style_t UiStyles::bodyStyle;
+lv_style_t UiStyles::captionStyle;
+lv_style_t UiStyles::fontStyles[5];
+
+static const uint8_t FONT_SIZES[5] = { 12, 14, 16, 18, 20 };
+
+static const lv_font_t* montserrat(uint8_t size) {
+    switch (size) {
+#if LV_FONT_MONTSERRAT_12
+        case 12: return &lv_font_montserrat_12;
+#endif
+#if LV_FONT_MONTSERRAT_14
+        case 14: return &lv_font_montserrat_14;
+#endif
+#if LV_FONT_MONTSERRAT_16
+        case 16: return &lv_font_montserrat_16;
+#endif
+#if LV_FONT_MONTSERRAT_18
+        case 18: return &lv_font_montserrat_18;
+#endif
+#if LV_FONT_MONTSERRAT_20
+        case 20: return &lv_font_montserrat_20;
+#endif
+        default: return nullptr;
+    }
+}
+
+void UiStyles::begin() {
+    if (initialized) return;
+
+    lv_style_init(&titleStyle);
+#if LV_FONT_MONTSERRAT_20
+    lv_style_set_text_font(&titleStyle, &lv_font_montserrat_20);
+#else
+    lv_style_set_text_font(&titleStyle, LV_FONT_DEFAULT);
+#endif
+
+    lv_style_init(&bodyStyle);
+    lv_style_set_text_font(&bodyStyle, LV_FONT_DEFAULT);
+
+    lv_style_init(&captionStyle);
+    lv_style_set_text_color(&captionStyle, lv_palette_main(LV_PALETTE_GREY));
+#if LV_FONT_MONTSERRAT_12
+    lv_style_set_text_font(&captionStyle, &lv_font_montserrat_12);
+#endif
+
+    for (int i = 0; i < 5; i++) {
+        lv_style_init(&fontStyles[i]);
+        const lv_font_t* f = montserrat(FONT_SIZES[i]);
+        if (f) lv_style_set_text_font(&fontStyles[i], f);
+    }
+
+    initialized = true;
+}
+
+lv_style_t* UiStyles::font(uint8_t size) {
+    for (int i = 0; i < 5; i++) {
+        if (FONT_SIZES[i] == size) return montserrat(size) ? &fontStyles[i] : nullptr;
+    }
+    return nullptr;
+}
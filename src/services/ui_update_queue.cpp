@@ -0,0 +1,216 @@
+#include "ui_update_queue.h"
+#include "ui_scheduler.h"
+#include <stdarg.h>
+
+// Static member definitions
+UiUpdateQueue::Entry UiUpdateQueue::entries[CAPACITY] = {};
+int UiUpdateQueue::pending = 0;
+portMUX_TYPE UiUpdateQueue::lock = portMUX_INITIALIZER_UNLOCKED;
+UiUpdateQueue::Binding UiUpdateQueue::bindings[MAX_BINDINGS] = {};
+uint32_t UiUpdateQueue::posted = 0;
+uint32_t UiUpdateQueue::coalesced = 0;
+uint32_t UiUpdateQueue::applied = 0;
+uint32_t UiUpdateQueue::dropped = 0;
+uint32_t UiUpdateQueue::stale = 0;
+uint32_t UiUpdateQueue::drains = 0;
+
+bool UiUpdateQueue::setText(UiHandle target, const char* text) {
+    return post(target, UiProp::Text, 0, text);
+}
+
+bool UiUpdateQueue::setTextf(UiHandle target, const char* format, ...) {
+    char text[TEXT_MAX];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return post(target, UiProp::Text, 0, text);
+}
+
+bool UiUpdateQueue::setValue(UiHandle target, int32_t value) {
+    return post(target, UiProp::Value, value, nullptr);
+}
+
+bool UiUpdateQueue::setHidden(UiHandle target, bool hidden) {
+    return post(target, UiProp::Hidden, hidden ? 1 : 0, nullptr);
+}
+
+bool UiUpdateQueue::setTextColor(UiHandle target, uint32_t rgb) {
+    return post(target, UiProp::TextColor, (int32_t)rgb, nullptr);
+}
+
+bool UiUpdateQueue::post(UiHandle target, UiProp prop, int32_t value, const char* text) {
+    if (target == UI_HANDLE_NONE) return false;
+
+    bool wasEmpty;
+    bool stored = false;
+    bool merged = false;
+
+    portENTER_CRITICAL(&lock);
+    posted++;
+    wasEmpty = pending == 0;
+
+    // Latest value wins - reuse the slot for this widget property if there is one
+    Entry* slot = nullptr;
+    for (int i = 0; i < CAPACITY; i++) {
+        Entry& e = entries[i];
+        if (e.target == target && e.prop == prop) {
+            slot = &e;
+            merged = true;
+            break;
+        }
+        if (e.target == UI_HANDLE_NONE && !slot) slot = &e;
+    }
+
+    if (slot) {
+        slot->target = target;
+        slot->prop = prop;
+        slot->value = value;
+        if (text) strlcpy(slot->text, text, TEXT_MAX);
+        if (merged) coalesced++;
+        else pending++;
+        stored = true;
+    } else {
+        dropped++;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    // One wakeup per batch is enough
+    if (stored && wasEmpty) {
+        UiScheduler::notify(UI_EVENT_REQUEST);
+    }
+    return stored;
+}
+
+UiHandle UiUpdateQueue::bind(lv_obj_t* obj) {
+    if (!obj) return UI_HANDLE_NONE;
+    for (int i = 0; i < MAX_BINDINGS; i++) {
+        Binding& b = bindings[i];
+        if (b.obj) continue;
+        b.generation = (b.generation + 1) & 0xFFFFFF;
+        if (b.generation == 0) b.generation = 1;
+        b.obj = obj;
+        return (b.generation << 8) | (uint32_t)i;
+    }
+    return UI_HANDLE_NONE;
+}
+
+lv_obj_t* UiUpdateQueue::resolve(UiHandle target) {
+    uint32_t index = target & 0xFF;
+    if (target == UI_HANDLE_NONE || index >= (uint32_t)MAX_BINDINGS) return nullptr;
+    const Binding& b = bindings[index];
+    return b.generation == (target >> 8) ? b.obj : nullptr;
+}
+
+void UiUpdateQueue::unbind(UiHandle target) {
+    if (!resolve(target)) return;   // Never bound, or already unbound
+    Binding& b = bindings[target & 0xFF];
+    b.obj = nullptr;
+    b.generation = (b.generation + 1) & 0xFFFFFF;   // Old handles stop resolving
+    if (b.generation == 0) b.generation = 1;
+    discard(target);
+}
+
+void UiUpdateQueue::discard(UiHandle target) {
+    portENTER_CRITICAL(&lock);
+    for (int i = 0; i < CAPACITY; i++) {
+        if (entries[i].target == target) {
+            entries[i].target = UI_HANDLE_NONE;
+            pending--;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void UiUpdateQueue::drain() {
+    if (pending == 0) return;
+
+    // Take everything in one short critical section, apply outside it
+    static Entry batch[CAPACITY];
+    int count = 0;
+
+    portENTER_CRITICAL(&lock);
+    for (int i = 0; i < CAPACITY && count < pending; i++) {
+        if (entries[i].target != UI_HANDLE_NONE) {
+            batch[count++] = entries[i];
+            entries[i].target = UI_HANDLE_NONE;
+        }
+    }
+    pending = 0;
+    portEXIT_CRITICAL(&lock);
+
+    drains++;
+    for (int i = 0; i < count; i++) {
+        // The widget may have been unbound after the update was posted
+        lv_obj_t* obj = resolve(batch[i].target);
+        if (!obj) {
+            stale++;
+            continue;
+        }
+        apply(obj, batch[i]);
+        applied++;
+    }
+}
+
+void UiUpdateQueue::apply(lv_obj_t* obj, const Entry& entry) {
+    switch (entry.prop) {
+        case UiProp::Text:
+            if (lv_obj_check_type(obj, &lv_label_class)) {
+                // Skip identical text so unchanged values don't invalidate
+                const char* current = lv_label_get_text(obj);
+                if (!current || strcmp(current, entry.text) != 0) {
+                    lv_label_set_text(obj, entry.text);
+                }
+            }
+            break;
+        case UiProp::Value:
+            if (lv_obj_check_type(obj, &lv_bar_class)) {
+                lv_bar_set_value(obj, entry.value, LV_ANIM_OFF);
+            } else if (lv_obj_check_type(obj, &lv_arc_class)) {
+                lv_arc_set_value(obj, entry.value);
+            } else if (lv_obj_check_type(obj, &lv_slider_class)) {
+                lv_slider_set_value(obj, entry.value, LV_ANIM_OFF);
+            }
+            break;
+        case UiProp::Hidden:
+            if (entry.value) lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+            else lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+            break;
+        case UiProp::TextColor:
+            lv_obj_set_style_text_color(obj, lv_color_hex((uint32_t)entry.value), 0);
+            break;
+    }
+}
+
+void UiUpdateQueue::purge(lv_obj_t* root) {
+    if (!root) return;
+
+    for (int i = 0; i < MAX_BINDINGS; i++) {
+        lv_obj_t* obj = bindings[i].obj;
+        if (!obj) continue;
+
+        // A widget deleted without unbind() is gone too - never follow its parent pointer
+        bool under = !lv_obj_is_valid(obj);
+        for (lv_obj_t* o = obj; !under && o; o = lv_obj_get_parent(o)) {
+            under = o == root;
+        }
+        if (under) unbind((bindings[i].generation << 8) | (uint32_t)i);
+    }
+}
+
+void UiUpdateQueue::printStats() {
+    Serial.println("\n=== UI UPDATE QUEUE ===");
+    Serial.printf("Posted:    %lu\n", posted);
+    Serial.printf("Coalesced: %lu (%.0f%%)\n", coalesced, posted ? coalesced * 100.0f / posted : 0.0f);
+    Serial.printf("Applied:   %lu in %lu drains\n", applied, drains);
+    Serial.printf("Dropped:   %lu (queue full), %lu stale targets\n", dropped, stale);
+    Serial.printf("Pending:   %d / %d\n", pending, CAPACITY);
+    int bound = 0;
+    for (int i = 0; i < MAX_BINDINGS; i++) bound += bindings[i].obj != nullptr;
+    Serial.printf("Bound:     %d / %d widgets\n", bound, MAX_BINDINGS);
+    Serial.println("=======================\n");
+}
+
+void UiUpdateQueue::resetStats() {
+    posted = coalesced = applied = dropped = stale = drains = 0;
+}
@@ -0,0 +1,168 @@
+#include "widget_pool.h"
+#include "ui_update_queue.h"
+
+// Marks objects that belong to the pool
+#define POOLED_FLAG LV_OBJ_FLAG_USER_1
+
+// Static member definitions
+WidgetPool::Pool WidgetPool::pools[(int)PooledWidget::Count] = {};
+lv_obj_t* WidgetPool::parking = nullptr;
+bool WidgetPool::enabled = true;
+size_t WidgetPool::lentBytes = 0;
+
+static const char* POOL_NAMES[(int)PooledWidget::Count] = { "label", "arc", "bar" };
+
+void WidgetPool::begin(int labels, int arcs, int bars) {
+    if (parking) return;
+    parking = lv_obj_create(NULL);
+
+    const int warm[(int)PooledWidget::Count] = { labels, arcs, bars };
+    for (int t = 0; t < (int)PooledWidget::Count; t++) {
+        Pool& pool = pools[t];
+        for (int i = 0; i < warm[t] && pool.count < CAPACITY; i++) {
+            lv_obj_t* obj = create((PooledWidget)t, parking);
+            lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+            pool.free[pool.count++] = obj;
+        }
+    }
+}
+
+lv_obj_t* WidgetPool::create(PooledWidget type, lv_obj_t* parent) {
+    Pool& pool = pools[(int)type];
+    lv_mem_monitor_t before;
+    if (!pool.defaultsKnown) lv_mem_monitor(&before);
+
+    lv_obj_t* obj;
+    switch (type) {
+        case PooledWidget::Arc: obj = lv_arc_create(parent); break;
+        case PooledWidget::Bar: obj = lv_bar_create(parent); break;
+        default:                obj = lv_label_create(parent); break;
+    }
+    lv_obj_add_flag(obj, POOLED_FLAG);
+
+    // Remember the constructor's size - restyling on return clears it - and
+    // what the widget costs, to charge it to the screens that borrow it
+    if (!pool.defaultsKnown) {
+        lv_mem_monitor_t after;
+        lv_mem_monitor(&after);
+        pool.objectBytes = before.free_size > after.free_size ? before.free_size - after.free_size : 0;
+        pool.defaultWidth = lv_obj_get_style_width(obj, LV_PART_MAIN);
+        pool.defaultHeight = lv_obj_get_style_height(obj, LV_PART_MAIN);
+        pool.defaultFlags = obj->flags;
+        pool.defaultsKnown = true;
+    }
+    return obj;
+}
+
+lv_obj_t* WidgetPool::borrow(PooledWidget type, lv_obj_t* parent) {
+    Pool& pool = pools[(int)type];
+    if (!enabled || pool.count == 0) {
+        pool.misses++;
+        return create(type, parent);
+    }
+
+    pool.hits++;
+    lentBytes += pool.objectBytes;
+    lv_obj_t* obj = pool.free[--pool.count];
+    lv_obj_set_parent(obj, parent);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    return obj;
+}
+
+void WidgetPool::giveBack(PooledWidget type, lv_obj_t* obj) {
+    Pool& pool = pools[(int)type];
+    if (pool.count >= CAPACITY) {
+        pool.discards++;
+        lv_obj_del(obj);
+        return;
+    }
+
+    // Back to the state create() left it in - nothing the borrower set may
+    // reach the next one
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_parent(obj, parking);
+    while (lv_obj_remove_event_cb(obj, NULL)) {
+    }
+    lv_group_remove_obj(obj);
+    lv_obj_set_user_data(obj, NULL);
+    lv_obj_clear_flag(obj, obj->flags & ~(pool.defaultFlags | LV_OBJ_FLAG_HIDDEN));
+    lv_obj_add_flag(obj, pool.defaultFlags);
+    lv_theme_apply(obj);  // Removes every style first
+    lv_obj_clear_state(obj, LV_STATE_ANY);
+    lv_obj_set_size(obj, pool.defaultWidth, pool.defaultHeight);
+    lv_obj_set_pos(obj, 0, 0);
+
+    // Widget properties outside styles, at their LVGL 8.3 constructor defaults
+    switch (type) {
+        case PooledWidget::Arc:
+            lv_arc_set_mode(obj, LV_ARC_MODE_NORMAL);
+            lv_arc_set_rotation(obj, 0);
+            lv_arc_set_bg_angles(obj, 135, 45);
+            lv_arc_set_range(obj, 0, 100);
+            lv_arc_set_change_rate(obj, 720);
+            lv_obj_set_ext_click_area(obj, LV_DPI_DEF / 10);
+            lv_arc_set_value(obj, 0);
+            break;
+        case PooledWidget::Bar:
+            lv_bar_set_mode(obj, LV_BAR_MODE_NORMAL);
+            lv_bar_set_range(obj, 0, 100);
+            lv_bar_set_value(obj, 0, LV_ANIM_OFF);
+            break;
+        default:
+            lv_label_set_long_mode(obj, LV_LABEL_LONG_WRAP);
+            lv_label_set_recolor(obj, false);
+            lv_label_set_text_static(obj, "");
+            break;
+    }
+
+    pool.returns++;
+    pool.free[pool.count++] = obj;
+}
+
+bool WidgetPool::typeOf(lv_obj_t* obj, PooledWidget& type) {
+    if (!lv_obj_has_flag(obj, POOLED_FLAG)) return false;
+    if (lv_obj_check_type(obj, &lv_label_class)) type = PooledWidget::Label;
+    else if (lv_obj_check_type(obj, &lv_arc_class)) type = PooledWidget::Arc;
+    else if (lv_obj_check_type(obj, &lv_bar_class)) type = PooledWidget::Bar;
+    else return false;
+    return true;
+}
+
+void WidgetPool::reclaim(lv_obj_t* root) {
+    if (!root) return;
+
+    // A recycled widget must not keep its handle - posts through it would land on its next owner
+    UiUpdateQueue::purge(root);
+    if (enabled) reclaimChildren(root);
+}
+
+void WidgetPool::reclaimChildren(lv_obj_t* root) {
+    // Walk backwards - returning a widget removes it from this child list
+    for (int i = (int)lv_obj_get_child_cnt(root) - 1; i >= 0; i--) {
+        lv_obj_t* child = lv_obj_get_child(root, i);
+        PooledWidget type;
+        if (typeOf(child, type)) {
+            giveBack(type, child);
+        } else {
+            reclaimChildren(child);
+        }
+    }
+}
+
+void WidgetPool::printStats() {
+    Serial.println("\n=== WIDGET POOL ===");
+    Serial.printf("Pooling %s\n", enabled ? "enabled" : "disabled");
+    Serial.println("  type    free   hits  misses  returns  discards  bytes");
+    for (int t = 0; t < (int)PooledWidget::Count; t++) {
+        const Pool& pool = pools[t];
+        Serial.printf("  %-6s %5d %6lu %7lu %8lu %9lu  %5u\n", POOL_NAMES[t], pool.count,
+                      pool.hits, pool.misses, pool.returns, pool.discards, (unsigned)pool.objectBytes);
+    }
+    Serial.println("===================\n");
+}
+
+void WidgetPool::resetStats() {
+    for (int t = 0; t < (int)PooledWidget::Count; t++) {
+        pools[t].hits = pools[t].misses = pools[t].returns = pools[t].discards = 0;
+    }
+}
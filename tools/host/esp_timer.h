@@ -0,0 +1,11 @@
+/*
+ * Host stand-in for ESP-IDF's esp_timer.h, for the host tools that compile
+ * LVGL sources with the project's lv_conf.h (LV_TICK_CUSTOM_INCLUDE).
+ * The tool that links them defines esp_timer_get_time() on a simulated clock.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void); /*!< Microseconds since boot */
@@ -0,0 +1,185 @@
+/*
+ * Host test for the knob decoder.
+ *
+ * Runs synthetic pin traces through src/drivers/knob_decoder.c and checks
+ * the counts: slow and fast spins in both directions, contact bounce,
+ * transitions the bidirectional switch cannot make, quadrature, and the
+ * pulse counter backend's path.
+ *
+ * Build (from the repository root):
+ *   cc -O2 -Iinclude -o knob_decoder_test tools/knob_decoder_test.c src/drivers/knob_decoder.c
+ *
+ * Usage:
+ *   knob_decoder_test
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "knob_decoder.h"
+
+/* Sample period of the timer backend (TICKS_INTERVAL in bidi_switch_knob.c);
+ * pins are active low, idle high */
+#define TRACE_TICK_US 3000
+
+typedef struct
+{
+    int count;
+    int accel_count;
+    uint32_t velocity;
+    uint32_t rejected;
+    uint32_t invalid;
+} trace_result_t;
+
+static trace_result_t result_of(const knob_decoder_t *dec, uint32_t now)
+{
+    trace_result_t r = {dec->count, dec->accel_count, knob_decoder_velocity(dec, now), dec->rejected, dec->invalid};
+    return r;
+}
+
+static void sample_bidi(knob_decoder_t *dec, uint32_t *now, uint8_t level, bool left)
+{
+    knob_decoder_sample(dec, left ? 1 : level, left ? level : 1, *now);
+    *now += TRACE_TICK_US;
+}
+
+/* Detents on the bidirectional switch: each pulls one line low for low_ticks
+ * then releases it for high_ticks. bounce adds that many one-sample glitches
+ * at both ends of every pulse. */
+static trace_result_t run_bidi(int detents, int low_ticks, int high_ticks, int bounce, bool left)
+{
+    knob_decoder_t dec;
+    knob_decoder_init(&dec, KNOB_DECODER_BIDI, 1, 1);
+    uint32_t now = 0;
+
+    for (int d = 0; d < detents; d++)
+    {
+        for (int i = 0; i < bounce; i++)
+        {
+            sample_bidi(&dec, &now, 0, left);
+            sample_bidi(&dec, &now, 1, left);
+        }
+        for (int i = 0; i < low_ticks; i++)
+            sample_bidi(&dec, &now, 0, left);
+        for (int i = 0; i < bounce; i++)
+        {
+            sample_bidi(&dec, &now, 1, left);
+            sample_bidi(&dec, &now, 0, left);
+        }
+        for (int i = 0; i < high_ticks; i++)
+            sample_bidi(&dec, &now, 1, left);
+    }
+    return result_of(&dec, now);
+}
+
+/* Gray-code quadrature, four transitions per detent, each held hold_ticks */
+static trace_result_t run_quadrature(int detents, int hold_ticks, bool ccw)
+{
+    static const uint8_t CW[4] = {2, 0, 1, 3};  /* From rest (11): 10, 00, 01, 11 */
+    static const uint8_t CCW[4] = {1, 0, 2, 3}; /* From rest (11): 01, 00, 10, 11 */
+    const uint8_t *states = ccw ? CCW : CW;
+    knob_decoder_t dec;
+    knob_decoder_init(&dec, KNOB_DECODER_QUADRATURE, 1, 1);
+    uint32_t now = 0;
+
+    for (int d = 0; d < detents; d++)
+    {
+        for (int step = 0; step < 4; step++)
+        {
+            for (int i = 0; i < hold_ticks; i++)
+            {
+                knob_decoder_sample(&dec, states[step] >> 1, states[step] & 1, now);
+                now += TRACE_TICK_US;
+            }
+        }
+    }
+    trace_result_t r = result_of(&dec, now);
+    r.velocity = 0;
+    return r;
+}
+
+/* Both lines low is impossible on the bidirectional switch and must not count */
+static trace_result_t run_invalid(void)
+{
+    static const uint8_t trace[] = {3, 3, 1, 1, 1, 0, 0, 0, 1, 1, 3, 3, 3, 0, 0, 0, 3, 3, 3};
+    knob_decoder_t dec;
+    knob_decoder_init(&dec, KNOB_DECODER_BIDI, 1, 1);
+    uint32_t now = 0;
+    for (size_t i = 0; i < sizeof(trace); i++)
+    {
+        knob_decoder_sample(&dec, trace[i] >> 1, trace[i] & 1, now);
+        now += TRACE_TICK_US;
+    }
+    trace_result_t r = result_of(&dec, now);
+    r.velocity = 0;
+    return r;
+}
+
+/* Pulse counter path, one call per edge interrupt: both ends of every pulse
+ * bounce once, then five left pulses so short the line reads high again by
+ * the time the interrupt runs */
+static trace_result_t run_counter(void)
+{
+    knob_decoder_t dec;
+    knob_decoder_init(&dec, KNOB_DECODER_BIDI, 1, 1);
+    uint32_t now = 0;
+    for (int d = 0; d < 10; d++)
+    {
+        knob_decoder_edges(&dec, 0, 1, 1, now);
+        knob_decoder_edges(&dec, 1, 1, 0, now + 50);
+        knob_decoder_edges(&dec, 0, 1, 1, now + 100);
+        knob_decoder_edges(&dec, 1, 1, 0, now + 5000);
+        knob_decoder_edges(&dec, 0, 1, 1, now + 5050);
+        knob_decoder_edges(&dec, 1, 1, 0, now + 5100);
+        now += 20000;
+    }
+    for (int d = 0; d < 5; d++)
+    {
+        knob_decoder_edges(&dec, 1, 1, -1, now);
+        knob_decoder_edges(&dec, 1, 1, 0, now + 20);
+        now += 5000;
+    }
+    return result_of(&dec, now);
+}
+
+static int check(const char *name, bool pass, trace_result_t r)
+{
+    printf("  %-22s %s  count %4d  accel %4d  %3u/s  bounce %3u  invalid %u\n", name, pass ? "PASS" : "FAIL",
+           r.count, r.accel_count, (unsigned)r.velocity, (unsigned)r.rejected, (unsigned)r.invalid);
+    return pass ? 0 : 1;
+}
+
+int main(void)
+{
+    int failures = 0;
+    trace_result_t r;
+
+    /* ~7 detents/s: below the curve, one step per detent */
+    r = run_bidi(10, 5, 40, 0, false);
+    failures += check("slow right", r.count == 10 && r.accel_count == 10, r);
+    r = run_bidi(10, 5, 40, 0, true);
+    failures += check("slow left", r.count == -10 && r.accel_count == -10, r);
+
+    /* ~83 detents/s: every detent counted, accelerated past the curve */
+    r = run_bidi(30, 2, 2, 0, false);
+    failures += check("fast right", r.count == 30 && r.accel_count > 60 && r.velocity > 30, r);
+
+    /* Glitches shorter than the debounce at both ends of every pulse */
+    r = run_bidi(20, 4, 6, 1, false);
+    failures += check("bouncy right", r.count == 20 && r.rejected >= 40, r);
+    r = run_bidi(20, 4, 6, 3, true);
+    failures += check("very bouncy left", r.count == -20 && r.rejected >= 120, r);
+
+    r = run_invalid();
+    failures += check("invalid transitions", r.count == 1 && r.invalid == 2, r);
+
+    r = run_quadrature(10, 2, false);
+    failures += check("quadrature cw", r.count == 10, r);
+    r = run_quadrature(10, 2, true);
+    failures += check("quadrature ccw", r.count == -10, r);
+
+    r = run_counter();
+    failures += check("counter edges", r.count == 5 && r.rejected == 20, r);
+
+    printf("%s\n", failures ? "knob decoder test FAILED" : "knob decoder test passed");
+    return failures ? 1 : 0;
+}
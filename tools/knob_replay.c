@@ -0,0 +1,392 @@
+/*
+ * Host replay harness for the knob decoder.
+ *
+ * Replays a capture from the device ("knob trace dump") or a synthetic
+ * trace through src/drivers/knob_decoder.c, once as the timer backend
+ * sees it (levels sampled every tick) and once as the pulse counter
+ * backend does (an interrupt per glitch-filtered edge with the falling
+ * edges counted), and reports missed steps, false steps and decode cost.
+ *
+ * Build (from the repository root):
+ *   cc -O2 -Iinclude -o knob_replay tools/knob_replay.c src/drivers/knob_decoder.c
+ *
+ * Usage:
+ *   knob_replay [--expect N] [--tick US] trace.txt
+ *       Captured trace. N is the signed number of detents actually turned
+ *       (right positive); without it the device's own count is the reference.
+ *   knob_replay --synth detents=N,dps=D,jitter=PCT,bounce=K,bounce_us=U,dir=right|left,seed=S [--tick US]
+ *       Synthetic trace with known ground truth. Every field is optional.
+ *   knob_replay --regress
+ *       Fast, bouncy synthetic runs the pulse counter backend once lost
+ *       detents on; fails if it misses or invents more than each allows.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "knob_decoder.h"
+
+#define DEFAULT_TICK_US   3000   /* TICKS_INTERVAL in bidi_switch_knob.c */
+#define PCNT_FILTER_US    12.8   /* 1023 APB cycles at 80 MHz */
+#define TAIL_US           50000  /* Keep sampling after the last edge */
+
+typedef struct
+{
+    uint32_t t;
+    uint8_t a, b;
+} edge_t;
+
+typedef struct
+{
+    edge_t *edges;
+    size_t count, cap;
+    uint8_t start_a, start_b;
+    int reference;      /* Detents expected, right positive */
+    int has_reference;
+    const char *reference_name;
+} trace_t;
+
+typedef struct
+{
+    int right, left;
+    uint32_t bounce, invalid;
+    double ns_per_call;
+    size_t calls;
+} result_t;
+
+static void push_edge(trace_t *tr, uint32_t t, uint8_t a, uint8_t b)
+{
+    if (tr->count == tr->cap)
+    {
+        tr->cap = tr->cap ? tr->cap * 2 : 1024;
+        tr->edges = realloc(tr->edges, tr->cap * sizeof(edge_t));
+        if (!tr->edges)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    tr->edges[tr->count].t = t;
+    tr->edges[tr->count].a = a;
+    tr->edges[tr->count].b = b;
+    tr->count++;
+}
+
+static int load_trace(const char *path, trace_t *tr)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        perror(path);
+        return 0;
+    }
+
+    char line[256];
+    tr->start_a = tr->start_b = 1;
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned long t;
+        unsigned a, b;
+        int steps;
+        if (line[0] == '#')
+        {
+            const char *p;
+            if ((p = strstr(line, "start a=")) && sscanf(p, "start a=%u b=%u", &a, &b) == 2)
+            {
+                tr->start_a = (uint8_t)a;
+                tr->start_b = (uint8_t)b;
+            }
+            if ((p = strstr(line, "device_steps=")) && sscanf(p, "device_steps=%d", &steps) == 1 && !tr->has_reference)
+            {
+                tr->reference = steps;
+                tr->has_reference = 1;
+                tr->reference_name = "device count";
+            }
+            continue;
+        }
+        if (sscanf(line, "%lu %u %u", &t, &a, &b) == 3)
+            push_edge(tr, (uint32_t)t, (uint8_t)a, (uint8_t)b);
+    }
+    fclose(f);
+    return 1;
+}
+
+/* Small deterministic generator so synthetic runs are repeatable */
+static uint32_t rng_state = 1;
+static uint32_t rng(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+static double rng_unit(void) { return (rng() & 0xFFFF) / 65535.0; }
+
+static void synth_trace(const char *spec, trace_t *tr)
+{
+    int detents = 20, dps = 10, jitter = 0, bounce = 0, bounce_us = 500, left = 0;
+    unsigned seed = 1;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ","))
+    {
+        sscanf(tok, "detents=%d", &detents);
+        sscanf(tok, "dps=%d", &dps);
+        sscanf(tok, "jitter=%d", &jitter);
+        sscanf(tok, "bounce=%d", &bounce);
+        sscanf(tok, "bounce_us=%d", &bounce_us);
+        sscanf(tok, "seed=%u", &seed);
+        if (strcmp(tok, "dir=left") == 0)
+            left = 1;
+    }
+    if (dps < 1)
+        dps = 1;
+    rng_state = seed;
+
+    printf("synthetic: %d detents %s at %d/s, jitter %d%%, %d bounces within %d us\n",
+           detents, left ? "left" : "right", dps, jitter, bounce, bounce_us);
+
+    tr->start_a = tr->start_b = 1;
+    tr->reference = left ? -detents : detents;
+    tr->has_reference = 1;
+    tr->reference_name = "synthetic truth";
+
+    /* One line pulses low for 40% of each detent period */
+    double t = 20000;
+    for (int d = 0; d < detents; d++)
+    {
+        double period = 1e6 / dps * (1.0 + jitter / 100.0 * (rng_unit() * 2 - 1));
+        double low = period * 0.4;
+        for (int edge = 0; edge < 2; edge++)
+        {
+            uint8_t level = edge == 0 ? 0 : 1;
+            double at = edge == 0 ? t : t + low;
+            /* The line is driven the other way here; bounce cannot run past it */
+            double until = edge == 0 ? t + low : t + period;
+            /* Contact bounce: the line flips back and forth before settling */
+            for (int k = 0; k < bounce; k++)
+            {
+                double gap = 1 + rng_unit() * bounce_us / (bounce + 1);
+                if (at + 2 * gap >= until)
+                    break;
+                push_edge(tr, (uint32_t)at, left ? 1 : level, left ? level : 1);
+                at += gap;
+                push_edge(tr, (uint32_t)at, left ? 1 : !level, left ? !level : 1);
+                at += gap;
+            }
+            push_edge(tr, (uint32_t)at, left ? 1 : level, left ? level : 1);
+        }
+        t += period;
+    }
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void tally(result_t *r, int dir)
+{
+    if (dir > 0)
+        r->right++;
+    else if (dir < 0)
+        r->left++;
+}
+
+/* Timer backend: levels sampled every tick_us */
+static result_t replay_timer(const trace_t *tr, uint32_t tick_us)
+{
+    result_t r = {0};
+    knob_decoder_t dec;
+    knob_decoder_init(&dec, KNOB_DECODER_BIDI, tr->start_a, tr->start_b);
+
+    uint32_t end = (tr->count ? tr->edges[tr->count - 1].t : 0) + TAIL_US;
+    uint8_t a = tr->start_a, b = tr->start_b;
+    size_t next = 0;
+
+    double start = now_ns();
+    for (uint32_t t = 0; t <= end; t += tick_us)
+    {
+        while (next < tr->count && tr->edges[next].t <= t)
+        {
+            a = tr->edges[next].a;
+            b = tr->edges[next].b;
+            next++;
+        }
+        tally(&r, knob_decoder_sample(&dec, a, b, t));
+        r.calls++;
+    }
+    r.ns_per_call = r.calls ? (now_ns() - start) / r.calls : 0;
+    r.bounce = dec.rejected;
+    r.invalid = dec.invalid;
+    return r;
+}
+
+/* Time the line an edge changed next changes again, so the edge's level held until then */
+static double held_until(const trace_t *tr, size_t i, int line_b)
+{
+    uint8_t level = line_b ? tr->edges[i].b : tr->edges[i].a;
+    for (size_t j = i + 1; j < tr->count; j++)
+    {
+        if ((line_b ? tr->edges[j].b : tr->edges[j].a) != level)
+            return tr->edges[j].t;
+    }
+    return 1e18;
+}
+
+/* Pulse counter backend: falling edges counted through the hardware glitch
+ * filter (A up, B down), and an interrupt for every filtered edge on either
+ * line that reads the count and the lines. The filter passes a level once
+ * it has held for PCNT_FILTER_US, so a run of short glitches still ends in
+ * one edge if the line finishes at the other level. */
+static result_t replay_pcnt(const trace_t *tr)
+{
+    result_t r = {0};
+    knob_decoder_t dec;
+    knob_decoder_init(&dec, KNOB_DECODER_BIDI, tr->start_a, tr->start_b);
+
+    uint8_t a = tr->start_a, b = tr->start_b;
+
+    double start = now_ns();
+    for (size_t i = 0; i < tr->count; i++)
+    {
+        const edge_t *e = &tr->edges[i];
+        int counted = 0, falls = 0;
+        if (e->a != a && held_until(tr, i, 0) - e->t >= PCNT_FILTER_US)
+        {
+            a = e->a;
+            counted = 1;
+            falls += !a;
+        }
+        if (e->b != b && held_until(tr, i, 1) - e->t >= PCNT_FILTER_US)
+        {
+            b = e->b;
+            counted = 1;
+            falls -= !b;
+        }
+
+        if (counted)
+        {
+            tally(&r, knob_decoder_edges(&dec, a, b, falls, e->t + (uint32_t)PCNT_FILTER_US));
+            r.calls++;
+        }
+    }
+    r.ns_per_call = r.calls ? (now_ns() - start) / r.calls : 0;
+    r.bounce = dec.rejected;
+    r.invalid = dec.invalid;
+    return r;
+}
+
+static int report(const char *name, const result_t *r, const trace_t *tr)
+{
+    printf("%-14s right %4d  left %4d  bounce %5u  invalid %4u  %8zu calls  %6.1f ns/call",
+           name, r->right, r->left, r->bounce, r->invalid, r->calls, r->ns_per_call);
+    if (!tr->has_reference)
+    {
+        printf("\n");
+        return 0;
+    }
+
+    int want = tr->reference;
+    int good = want >= 0 ? r->right : r->left;
+    int wrong = want >= 0 ? r->left : r->right;
+    int target = abs(want);
+    int missed = good < target ? target - good : 0;
+    int extra = wrong + (good > target ? good - target : 0);
+    printf("  missed %d  false %d\n", missed, extra);
+    return missed + extra;
+}
+
+/* Runs that lost detents while the counter backend waited for the lines to
+ * go quiet; allowed is missed plus false steps on the pulse counter. At
+ * 250/s with 1.5 ms of bounce at each end of a 1.6 ms pulse the bounce
+ * can bridge a whole release, so one detent in fifty may merge. */
+static const struct
+{
+    const char *spec;
+    int allowed;
+} REGRESSIONS[] = {
+    {"detents=50,dps=250,jitter=20,bounce=5,bounce_us=1500", 1},
+    {"detents=50,dps=200,jitter=20,bounce=5,bounce_us=1500", 0},
+    {"detents=50,dps=150,jitter=20,bounce=5,bounce_us=1500", 0},
+    {"detents=50,dps=100,jitter=20,bounce=5,bounce_us=1500,seed=2", 0},
+    {"detents=50,dps=250,jitter=20,bounce=3,bounce_us=800", 0},
+    {"detents=50,dps=250,jitter=20,bounce=3,bounce_us=800,dir=left", 0},
+};
+
+static int regress(void)
+{
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(REGRESSIONS) / sizeof(REGRESSIONS[0]); i++)
+    {
+        trace_t tr = {0};
+        synth_trace(REGRESSIONS[i].spec, &tr);
+        result_t pcnt = replay_pcnt(&tr);
+        int errors = report("pulse counter", &pcnt, &tr);
+        if (errors > REGRESSIONS[i].allowed)
+        {
+            printf("FAIL: %s (allowed %d)\n", REGRESSIONS[i].spec, REGRESSIONS[i].allowed);
+            failures++;
+        }
+        free(tr.edges);
+    }
+    printf("%s\n", failures ? "knob regression runs FAILED" : "knob regression runs passed");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    trace_t tr = {0};
+    uint32_t tick_us = DEFAULT_TICK_US;
+    const char *path = NULL;
+    const char *synth = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc)
+        {
+            tr.reference = atoi(argv[++i]);
+            tr.has_reference = 1;
+            tr.reference_name = "--expect";
+        }
+        else if (strcmp(argv[i], "--tick") == 0 && i + 1 < argc)
+            tick_us = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--regress") == 0)
+            return regress();
+        else if (strcmp(argv[i], "--synth") == 0)
+            synth = i + 1 < argc && argv[i + 1][0] != '-' ? argv[++i] : "";
+        else
+            path = argv[i];
+    }
+    if (!path && !synth)
+    {
+        fprintf(stderr, "usage: %s [--expect N] [--tick US] trace.txt\n"
+                        "       %s --synth detents=N,dps=D,jitter=PCT,bounce=K,bounce_us=U,dir=right|left,seed=S [--tick US]\n"
+                        "       %s --regress\n",
+                argv[0], argv[0], argv[0]);
+        return 2;
+    }
+
+    if (synth)
+        synth_trace(synth, &tr);
+    else if (!load_trace(path, &tr))
+        return 2;
+
+    printf("%zu edges over %.1f ms", tr.count, tr.count ? tr.edges[tr.count - 1].t / 1000.0 : 0.0);
+    if (tr.has_reference)
+        printf(", reference %+d detents (%s)", tr.reference, tr.reference_name);
+    printf("\n");
+
+    result_t timer = replay_timer(&tr, tick_us);
+    result_t pcnt = replay_pcnt(&tr);
+    char name[32];
+    snprintf(name, sizeof(name), "timer %ums", (unsigned)(tick_us / 1000));
+    int errors = report(name, &timer, &tr);
+    errors += report("pulse counter", &pcnt, &tr);
+
+    free(tr.edges);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * Host soak test for the app screen residency policy.
+ *
+ * Drives src/services/screen_residency.c the way AppManager does - switches,
+ * idle prefetch of the ring neighbours and budget changes - over a model of
+ * the app lifecycle, and checks after every step that:
+ *   - every trim terminates, even when evictions are refused
+ *   - the screen LVGL is showing and the active app are never evicted
+ *   - the resident count is back within the budget once a switch completes
+ *   - builds minus evictions always equals the resident count (no leak)
+ *
+ * Build (from the repository root):
+ *   cc -O2 -Iinclude -o residency_soak tools/residency_soak.c src/services/screen_residency.c
+ *
+ * Usage:
+ *   residency_soak [cycles] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "screen_residency.h"
+
+#define MAX_APPS 16
+
+/* BaseApp::State */
+typedef enum
+{
+    CREATED,
+    SUSPENDED,
+    ACTIVE,
+    EVICTED
+} state_t;
+
+typedef struct
+{
+    int count;
+    int current;
+    int shown;  /* lv_scr_act() */
+    int budget;
+    state_t state[MAX_APPS];
+    uint32_t last_used[MAX_APPS];
+    uint32_t use_counter;
+
+    uint32_t builds, evictions, evict_calls;
+    int failures;
+} model_t;
+
+static uint32_t rng_state = 1;
+static uint32_t rng(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+static void fail(model_t *m, const char *what)
+{
+    if (m->failures++ < 10)
+        printf("FAIL: %s\n", what);
+}
+
+static int built(const model_t *m, int i)
+{
+    return m->state[i] == SUSPENDED || m->state[i] == ACTIVE;
+}
+
+static int resident(const model_t *m)
+{
+    int n = 0;
+    for (int i = 0; i < m->count; i++)
+        n += built(m, i);
+    return n;
+}
+
+/* BaseApp::evict() through AppManager::evictApp() */
+static bool evict_app(int index, void *ctx)
+{
+    model_t *m = ctx;
+    m->evict_calls++;
+    if (index == m->shown)
+        fail(m, "evicted the screen LVGL is showing");
+    if (index == m->current)
+        fail(m, "evicted the active app");
+    if (m->state[index] != SUSPENDED)
+        return false;
+    m->state[index] = EVICTED;
+    m->evictions++;
+    return true;
+}
+
+/* AppManager::trimResident() */
+static bool trim(model_t *m, int limit, int keep, int also_keep)
+{
+    screen_slot_t slots[MAX_APPS];
+    for (int i = 0; i < m->count; i++)
+    {
+        slots[i].last_used = m->last_used[i];
+        slots[i].built = built(m, i);
+        slots[i].evictable = i != m->current && m->state[i] == SUSPENDED && i != m->shown;
+    }
+    uint32_t calls = m->evict_calls;
+    bool ok = screen_residency_trim(slots, m->count, limit, keep, also_keep, evict_app, m);
+    if (m->evict_calls - calls > (uint32_t)m->count)
+        fail(m, "trim offered a screen twice");
+    return ok;
+}
+
+static void build(model_t *m, int i)
+{
+    m->state[i] = SUSPENDED;
+    m->builds++;
+}
+
+/* AppManager::switchBy() + switchToCurrentApp() */
+static void switch_to(model_t *m, int target)
+{
+    if (target == m->current)
+        return;
+    m->state[m->current] = SUSPENDED;
+    m->current = target;
+    if (!built(m, target))
+    {
+        trim(m, m->budget - 1, target, -1);
+        build(m, target);
+    }
+    m->state[target] = ACTIVE;
+    m->shown = target; /* onEnter() loads the screen */
+    m->last_used[target] = ++m->use_counter;
+    trim(m, m->budget, target, -1);
+
+    if (resident(m) > m->budget)
+        fail(m, "over budget after a switch");
+}
+
+/* AppManager::prefetchApp() */
+static void prefetch(model_t *m, int index, int other)
+{
+    if (index == m->current || built(m, index))
+        return;
+    if (!trim(m, m->budget - 1, index, other))
+        return;
+    build(m, index);
+    m->last_used[index] = ++m->use_counter;
+    if (resident(m) > m->budget)
+        fail(m, "over budget after a prefetch");
+}
+
+/* AppManager::setResidentScreenBudget() */
+static void set_budget(model_t *m, int screens)
+{
+    m->budget = screens < 1 ? 1 : screens;
+    trim(m, m->budget, m->current, -1);
+    if (resident(m) > m->budget)
+        fail(m, "over budget after shrinking it");
+}
+
+static void check(model_t *m)
+{
+    if (m->builds - m->evictions != (uint32_t)resident(m))
+        fail(m, "builds and evictions do not balance");
+    if (m->state[m->current] != ACTIVE || m->shown != m->current)
+        fail(m, "active app not shown");
+}
+
+static bool refuse(int index, void *ctx)
+{
+    (void)index;
+    (*(int *)ctx)++;
+    return false;
+}
+
+static int regressions(void)
+{
+    int failures = 0;
+
+    /* Every eviction refused: trim must give up, not spin */
+    screen_slot_t slots[4] = {{1, true, true}, {2, true, true}, {3, true, true}, {4, true, false}};
+    int calls = 0;
+    if (screen_residency_trim(slots, 4, 1, 3, -1, refuse, &calls) || calls != 3)
+    {
+        printf("FAIL: refused evictions (%d calls)\n", calls);
+        failures++;
+    }
+
+    /* Nothing evictable: false straight away */
+    screen_slot_t pinned[2] = {{1, true, false}, {2, true, false}};
+    calls = 0;
+    if (screen_residency_trim(pinned, 2, 1, -1, -1, refuse, &calls) || calls != 0)
+    {
+        printf("FAIL: nothing evictable (%d calls)\n", calls);
+        failures++;
+    }
+
+    /* Budget 1: the outgoing screen stays until the new one is shown */
+    model_t m;
+    memset(&m, 0, sizeof(m));
+    m.count = 3;
+    m.budget = 1;
+    build(&m, 0);
+    m.state[0] = ACTIVE;
+    m.last_used[0] = ++m.use_counter;
+    switch_to(&m, 1);
+    switch_to(&m, 2);
+    switch_to(&m, 0);
+    check(&m);
+    if (resident(&m) != 1 || m.failures)
+    {
+        printf("FAIL: budget 1 (resident %d)\n", resident(&m));
+        failures++;
+    }
+
+    printf("regression cases %s\n", failures ? "FAILED" : "passed");
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    int cycles = argc > 1 ? atoi(argv[1]) : 100000;
+    rng_state = argc > 2 ? (uint32_t)atoi(argv[2]) : 1;
+
+    int failures = regressions();
+
+    model_t m;
+    memset(&m, 0, sizeof(m));
+    m.count = 6;
+    m.budget = 3;
+    build(&m, 0);
+    m.state[0] = ACTIVE;
+
+    for (int c = 0; c < cycles; c++)
+    {
+        uint32_t r = rng() % 100;
+        if (r < 70)
+        {
+            /* Knob detents: one step, or a coalesced burst */
+            int delta = (int)(rng() % 5) - 2;
+            switch_to(&m, ((m.current + delta) % m.count + m.count) % m.count);
+        }
+        else if (r < 95)
+        {
+            int next = (m.current + 1) % m.count;
+            int prev = (m.current + m.count - 1) % m.count;
+            prefetch(&m, next, prev);
+            prefetch(&m, prev, next);
+        }
+        else
+        {
+            set_budget(&m, (int)(rng() % 5)); /* 0 clamps to 1 */
+        }
+        check(&m);
+        if (m.failures)
+            break;
+    }
+
+    printf("%d cycles: %u builds, %u evictions, %u evict calls, %d resident / budget %d\n", cycles,
+           m.builds, m.evictions, m.evict_calls, resident(&m), m.budget);
+    failures += m.failures;
+    printf("%s\n", failures ? "residency soak FAILED" : "residency soak passed");
+    return failures ? 1 : 0;
+}
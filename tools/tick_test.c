@@ -0,0 +1,168 @@
+/*
+ * Host test for the LVGL tick source and the UI loop's idle wakeups.
+ *
+ * Links LVGL's own timer and animation code (lv_timer.c, lv_anim.c,
+ * lv_hal_tick.c) with the project's lv_conf.h, so the tick is the real
+ * LV_TICK_CUSTOM_SYS_TIME_EXPR read through a simulated esp_timer_get_time().
+ * Registers timers with the display refresh and input read periods, calls
+ * lv_timer_handler() and sleeps between passes the way UiScheduler::runOnce()
+ * does. Checks that the timers keep their period and that an animation
+ * started just before the 32-bit millisecond wrap (49.7 days of uptime)
+ * still runs to its end value on time, and reports how often an idle UI wakes.
+ *
+ * Build (from the repository root; the LVGL sources are the ones PlatformIO
+ * fetches into .pio/libdeps on the first 'pio run'):
+ *   LVGL=.pio/libdeps/esp32-s3-devkitc-1/lvgl
+ *   cc -O2 -DLV_CONF_INCLUDE_SIMPLE -I. -Iinclude -Itools/host -I$LVGL -o tick_test \
+ *      tools/tick_test.c $LVGL/src/hal/lv_hal_tick.c $LVGL/src/misc/lv_timer.c \
+ *      $LVGL/src/misc/lv_anim.c $LVGL/src/misc/lv_mem.c $LVGL/src/misc/lv_tlsf.c \
+ *      $LVGL/src/misc/lv_ll.c $LVGL/src/misc/lv_gc.c $LVGL/src/misc/lv_math.c \
+ *      $LVGL/src/misc/lv_log.c $LVGL/src/misc/lv_printf.c
+ *
+ * Usage:
+ *   tick_test [seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "esp_timer.h"
+#include <lvgl.h>
+#include "lcd_config.h"
+
+#if !LV_TICK_CUSTOM
+#error "The UI loop relies on LV_TICK_CUSTOM; lv_tick_inc() is never called"
+#endif
+
+#define ANIM_TIME_MS 300
+#define ANIM_END 100
+
+/* The clock behind LV_TICK_CUSTOM_SYS_TIME_EXPR */
+static int64_t sim_us;
+int64_t esp_timer_get_time(void) { return sim_us; }
+
+typedef struct
+{
+    const char *name;
+    uint32_t last_run;
+    uint32_t runs;
+    uint32_t worst_gap;
+} timer_log_t;
+
+static void timer_cb(lv_timer_t *timer)
+{
+    timer_log_t *log = (timer_log_t *)timer->user_data;
+    uint32_t now = lv_tick_get();
+    uint32_t gap = now - log->last_run;
+    if (log->runs && gap > log->worst_gap)
+        log->worst_gap = gap;
+    log->last_run = now;
+    log->runs++;
+}
+
+static int32_t anim_value = -1;
+static int anim_done;
+static uint32_t anim_start_tick;
+static uint32_t anim_took;
+
+static void anim_exec_cb(void *var, int32_t value) { *(int32_t *)var = value; }
+
+static void anim_ready_cb(lv_anim_t *a)
+{
+    (void)a;
+    anim_done = 1;
+    anim_took = lv_tick_elaps(anim_start_tick);
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = argc > 1 ? atoi(argv[1]) : 10;
+    if (seconds < 1)
+        seconds = 1;
+    int failures = 0;
+
+    /* The tick is the microsecond clock in milliseconds */
+    for (int64_t us = 0; us < 5000000; us += 777)
+    {
+        sim_us = us;
+        if (lv_tick_get() != (uint32_t)(us / 1000))
+        {
+            printf("tick mismatch at %lld us\n", (long long)us);
+            failures++;
+            break;
+        }
+    }
+
+    /* Start just before the millisecond counter wraps */
+    sim_us = ((int64_t)UINT32_MAX - (int64_t)seconds * 500) * 1000;
+    int64_t start_us = sim_us;
+
+    /* The parts of lv_init() the timer and animation code depend on */
+    lv_mem_init();
+    _lv_timer_core_init();
+    _lv_anim_core_init();
+
+    timer_log_t logs[] = {
+        {"display refresh", 0, 0, 0},
+        {"input read", 0, 0, 0},
+    };
+    const uint32_t periods[] = {LV_DISP_DEF_REFR_PERIOD, LV_INDEV_DEF_READ_PERIOD};
+    const int count = sizeof(logs) / sizeof(logs[0]);
+    for (int i = 0; i < count; i++)
+    {
+        logs[i].last_run = lv_tick_get();
+        lv_timer_create(timer_cb, periods[i], &logs[i]);
+    }
+
+    /* UiScheduler::runOnce(): sleep until the next LVGL deadline, clamped */
+    uint32_t wakeups = 0;
+    int anim_started = 0;
+    int64_t end = sim_us + (int64_t)seconds * 1000000;
+    while (sim_us < end)
+    {
+        /* An animation that straddles the wrap */
+        if (!anim_started && sim_us - start_us >= ((int64_t)seconds * 500 - ANIM_TIME_MS / 2) * 1000)
+        {
+            lv_anim_t a;
+            lv_anim_init(&a);
+            lv_anim_set_var(&a, &anim_value);
+            lv_anim_set_exec_cb(&a, anim_exec_cb);
+            lv_anim_set_values(&a, 0, ANIM_END);
+            lv_anim_set_time(&a, ANIM_TIME_MS);
+            lv_anim_set_ready_cb(&a, anim_ready_cb);
+            anim_start_tick = lv_tick_get();
+            lv_anim_start(&a);
+            anim_started = 1;
+        }
+
+        uint32_t next = lv_timer_handler();
+        if (next < EXAMPLE_LVGL_TASK_MIN_DELAY_MS)
+            next = EXAMPLE_LVGL_TASK_MIN_DELAY_MS;
+        if (next > EXAMPLE_LVGL_TASK_MAX_DELAY_MS)
+            next = EXAMPLE_LVGL_TASK_MAX_DELAY_MS;
+        sim_us += (int64_t)next * 1000;
+        wakeups++;
+    }
+
+    printf("%d s idle across the 32-bit ms wrap: %u wakeups (%.1f/s)\n", seconds, wakeups,
+           (double)wakeups / seconds);
+    for (int i = 0; i < count; i++)
+    {
+        const timer_log_t *t = &logs[i];
+        int ok = t->worst_gap == periods[i] && t->runs + 1 >= (uint32_t)(seconds * 1000 / periods[i]);
+        printf("  %-16s period %3u ms  runs %5u  worst gap %3u ms  %s\n", t->name, periods[i], t->runs,
+               t->worst_gap, ok ? "ok" : "FAIL");
+        failures += !ok;
+    }
+
+    /* The animation timer runs at the refresh period, so it may end up to one period late */
+    int anim_ok = anim_done && anim_value == ANIM_END && anim_took >= ANIM_TIME_MS &&
+                  anim_took <= ANIM_TIME_MS + LV_DISP_DEF_REFR_PERIOD;
+    printf("  %-16s %3u ms across the wrap: %s after %u ms, value %d  %s\n", "animation", ANIM_TIME_MS,
+           anim_done ? "ready" : "not ready", anim_took, (int)anim_value, anim_ok ? "ok" : "FAIL");
+    failures += !anim_ok;
+
+    printf("%s\n", failures ? "tick test FAILED" : "tick test passed");
+    return failures ? 1 : 0;
+}
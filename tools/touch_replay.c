@@ -0,0 +1,431 @@
+/*
+ * Host replay harness for the touch gesture recognizer.
+ *
+ * Replays a capture from the device ("touch trace dump") through
+ * src/drivers/touch_gesture.c and prints the gestures it recognises. A
+ * trace may list the gestures it should produce in "# expect" lines; any
+ * difference fails the run. --selftest replays a built-in set of
+ * synthetic traces with known gestures and checks the angle math against
+ * the C library.
+ *
+ * Build (from the repository root):
+ *   cc -O2 -Iinclude -o touch_replay tools/touch_replay.c src/drivers/touch_gesture.c -lm
+ *
+ * Usage:
+ *   touch_replay trace.txt|dir...
+ *       Captured traces, or directories whose *.txt traces are replayed in
+ *       name order (tools/fixtures/touch holds the checked-in set). Add the
+ *       gestures you performed to each file, one per line, before replaying:
+ *         # expect tap | double | long | swipe left|right|up|down | rotate +N|-N | nothing
+ *       (rotate N is the net number of steps of the whole drag)
+ *   touch_replay --selftest
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "touch_gesture.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MAX_GESTURES 64
+#define SAMPLE_US    10000   /* Report rate of the controller while touched */
+
+typedef struct
+{
+    uint32_t t;
+    uint8_t pressed;
+    int16_t x, y;
+} sample_t;
+
+typedef struct
+{
+    sample_t *samples;
+    size_t count, cap;
+    char expect[MAX_GESTURES][24];
+    int expected;
+    int checked;           /* Has "# expect" lines, possibly only "nothing" */
+} trace_t;
+
+typedef struct
+{
+    char seen[MAX_GESTURES][24];
+    int count;
+    int rotating;
+    int rotate_steps;      /* Net steps of the rotation in progress */
+    double ns_per_sample;
+} result_t;
+
+static const char *SWIPE_NAMES[] = {"none", "left", "right", "up", "down"};
+
+static void push_sample(trace_t *tr, uint32_t t, int pressed, int x, int y)
+{
+    if (tr->count == tr->cap)
+    {
+        tr->cap = tr->cap ? tr->cap * 2 : 256;
+        tr->samples = realloc(tr->samples, tr->cap * sizeof(sample_t));
+        if (!tr->samples)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    tr->samples[tr->count].t = t;
+    tr->samples[tr->count].pressed = (uint8_t)(pressed != 0);
+    tr->samples[tr->count].x = (int16_t)x;
+    tr->samples[tr->count].y = (int16_t)y;
+    tr->count++;
+}
+
+static void expect(trace_t *tr, const char *what)
+{
+    tr->checked = 1;
+    if (strcmp(what, "nothing") != 0 && tr->expected < MAX_GESTURES)
+        snprintf(tr->expect[tr->expected++], sizeof(tr->expect[0]), "%.23s", what);
+}
+
+static int load_trace(const char *path, trace_t *tr)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        perror(path);
+        return 0;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned long t;
+        int pressed, x, y;
+        if (strncmp(line, "# expect ", 9) == 0)
+        {
+            line[strcspn(line, "\r\n")] = 0;
+            expect(tr, line + 9);
+            continue;
+        }
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%lu %d %d %d", &t, &pressed, &x, &y) == 4)
+            push_sample(tr, (uint32_t)t, pressed, x, y);
+    }
+    fclose(f);
+    return 1;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void note(result_t *r, const char *what)
+{
+    if (r->count < MAX_GESTURES)
+        snprintf(r->seen[r->count++], sizeof(r->seen[0]), "%s", what);
+}
+
+// A rotation is one gesture however many events it took; close it when the finger lifts
+static void end_rotation(result_t *r)
+{
+    char buf[24];
+    if (!r->rotating)
+        return;
+    snprintf(buf, sizeof(buf), "rotate %+d", r->rotate_steps);
+    note(r, buf);
+    r->rotating = 0;
+    r->rotate_steps = 0;
+}
+
+static result_t replay(const trace_t *tr, int verbose)
+{
+    result_t r = {0};
+    touch_gesture_t g;
+    touch_gesture_event_t ev[TOUCH_GESTURE_MAX_EVENTS];
+    char buf[24];
+
+    touch_gesture_init(&g, NULL);
+    double start = now_ns();
+    for (size_t i = 0; i < tr->count; i++)
+    {
+        const sample_t *s = &tr->samples[i];
+        int n = touch_gesture_feed(&g, s->pressed, s->x, s->y, s->t, ev);
+        for (int k = 0; k < n; k++)
+        {
+            switch (ev[k].type)
+            {
+            case TOUCH_GESTURE_TAP:
+                note(&r, "tap");
+                break;
+            case TOUCH_GESTURE_DOUBLE_TAP:
+                note(&r, "double");
+                break;
+            case TOUCH_GESTURE_LONG_PRESS:
+                note(&r, "long");
+                break;
+            case TOUCH_GESTURE_SWIPE:
+                snprintf(buf, sizeof(buf), "swipe %s", SWIPE_NAMES[ev[k].swipe]);
+                note(&r, buf);
+                break;
+            case TOUCH_GESTURE_ROTATE:
+                r.rotating = 1;
+                r.rotate_steps += ev[k].steps;
+                break;
+            default:
+                break;
+            }
+            if (verbose)
+                printf("  %8.1f ms  type %d  swipe %d  angle %+6d  steps %+d  at %d,%d\n", s->t / 1000.0,
+                       ev[k].type, ev[k].swipe, ev[k].angle, ev[k].steps, ev[k].x, ev[k].y);
+        }
+        if (!s->pressed)
+            end_rotation(&r);
+    }
+    end_rotation(&r);
+    r.ns_per_sample = tr->count ? (now_ns() - start) / tr->count : 0;
+    return r;
+}
+
+static int check(const char *name, const trace_t *tr, const result_t *r)
+{
+    printf("%-22s %5zu samples  %5.1f ns/sample  ", name, tr->count, r->ns_per_sample);
+    for (int i = 0; i < r->count; i++)
+        printf("%s%s", i ? ", " : "", r->seen[i]);
+    if (!r->count)
+        printf("(nothing)");
+
+    if (!tr->checked)
+    {
+        printf("\n");
+        return 0;
+    }
+    int ok = tr->expected == r->count;
+    for (int i = 0; ok && i < r->count; i++)
+        ok = strcmp(tr->expect[i], r->seen[i]) == 0;
+    printf("  %s\n", ok ? "ok" : "MISMATCH");
+    if (!ok)
+    {
+        printf("    expected: ");
+        for (int i = 0; i < tr->expected; i++)
+            printf("%s%s", i ? ", " : "", tr->expect[i]);
+        printf("\n");
+    }
+    return ok ? 0 : 1;
+}
+
+/* ---- Synthetic traces ---- */
+
+static uint32_t t_now;
+
+static void idle(trace_t *tr, uint32_t us)
+{
+    push_sample(tr, t_now, 0, 0, 0);
+    t_now += us;
+}
+
+// Finger down at (x0,y0), moved in a straight line to (x1,y1) over us, lifted
+static void line(trace_t *tr, int x0, int y0, int x1, int y1, uint32_t us)
+{
+    int n = (int)(us / SAMPLE_US);
+    for (int i = 0; i <= n; i++)
+    {
+        int x = x0 + (x1 - x0) * i / (n ? n : 1);
+        int y = y0 + (y1 - y0) * i / (n ? n : 1);
+        push_sample(tr, t_now, 1, x, y);
+        t_now += SAMPLE_US;
+    }
+    idle(tr, SAMPLE_US);
+}
+
+// Finger dragged along a circle around the panel center, clockwise for positive degrees
+static void arc_path(trace_t *tr, double radius, double from_deg, double degrees, uint32_t us)
+{
+    int n = (int)(us / SAMPLE_US);
+    for (int i = 0; i <= n; i++)
+    {
+        double a = (from_deg + degrees * i / n) * M_PI / 180.0;
+        push_sample(tr, t_now, 1, (int)lround(180 + radius * cos(a)), (int)lround(180 + radius * sin(a)));
+        t_now += SAMPLE_US;
+    }
+}
+
+static void arc(trace_t *tr, double radius, double from_deg, double degrees, uint32_t us)
+{
+    arc_path(tr, radius, from_deg, degrees, us);
+    idle(tr, SAMPLE_US);
+}
+
+static int selftest(void)
+{
+    int failures = 0;
+    trace_t tr;
+
+#define CASE(name, build)                   \
+    do                                      \
+    {                                       \
+        memset(&tr, 0, sizeof(tr));         \
+        t_now = 0;                          \
+        idle(&tr, 50000);                   \
+        build;                              \
+        idle(&tr, 50000);                   \
+        result_t r = replay(&tr, 0);        \
+        failures += check(name, &tr, &r);   \
+        free(tr.samples);                   \
+    } while (0)
+
+    CASE("tap", (line(&tr, 180, 180, 182, 181, 80000), expect(&tr, "tap")));
+    CASE("double tap", (line(&tr, 200, 150, 200, 150, 60000), idle(&tr, 150000),
+                        line(&tr, 205, 155, 205, 155, 60000),
+                        expect(&tr, "tap"), expect(&tr, "double")));
+    CASE("two slow taps", (line(&tr, 200, 150, 200, 150, 60000), idle(&tr, 500000),
+                           line(&tr, 200, 150, 200, 150, 60000),
+                           expect(&tr, "tap"), expect(&tr, "tap")));
+    CASE("two distant taps", (line(&tr, 100, 180, 100, 180, 60000), idle(&tr, 100000),
+                              line(&tr, 260, 180, 260, 180, 60000),
+                              expect(&tr, "tap"), expect(&tr, "tap")));
+    CASE("triple tap", (line(&tr, 180, 180, 180, 180, 50000), idle(&tr, 100000),
+                        line(&tr, 180, 180, 180, 180, 50000), idle(&tr, 100000),
+                        line(&tr, 180, 180, 180, 180, 50000),
+                        expect(&tr, "tap"), expect(&tr, "double"), expect(&tr, "tap")));
+    CASE("long press", (line(&tr, 180, 180, 184, 183, 900000), expect(&tr, "long")));
+    CASE("long press on bezel", (line(&tr, 180, 20, 180, 20, 900000), expect(&tr, "long")));
+    CASE("swipe left", (line(&tr, 260, 180, 100, 190, 200000), expect(&tr, "swipe left")));
+    CASE("swipe right", (line(&tr, 100, 200, 260, 180, 200000), expect(&tr, "swipe right")));
+    CASE("swipe up", (line(&tr, 170, 280, 190, 90, 150000), expect(&tr, "swipe up")));
+    CASE("swipe down", (line(&tr, 180, 90, 180, 280, 150000), expect(&tr, "swipe down")));
+    CASE("swipe out of bezel", (line(&tr, 180, 30, 180, 200, 150000), expect(&tr, "swipe down")));
+    CASE("slow drag", (line(&tr, 100, 180, 260, 180, 1500000), expect(&tr, "nothing")));
+    CASE("short drag", (line(&tr, 180, 180, 210, 180, 100000), expect(&tr, "nothing")));
+    CASE("rotate cw 90", (arc(&tr, 160, -90, 90, 600000), expect(&tr, "rotate +6")));
+    CASE("rotate ccw 180", (arc(&tr, 150, 0, -180, 900000), expect(&tr, "rotate -12")));
+    CASE("rotate across 0", (arc(&tr, 165, -30, 60, 400000), expect(&tr, "rotate +4")));
+    CASE("rotate two turns", (arc(&tr, 160, 45, 720, 3000000), expect(&tr, "rotate +48")));
+    CASE("rotate and back", (arc_path(&tr, 160, 90, 60, 400000), arc(&tr, 160, 150, -60, 400000),
+                             expect(&tr, "rotate +0")));
+    CASE("rotate below start", (arc(&tr, 160, 0, 8, 300000), expect(&tr, "nothing")));
+    CASE("arc inside ring", (arc(&tr, 60, 0, 90, 500000), expect(&tr, "nothing")));
+#undef CASE
+
+    // Angle approximation against atan2, every direction at panel radii
+    double worst = 0;
+    for (int deg10 = 0; deg10 < 3600; deg10++)
+    {
+        for (int radius = 20; radius <= 200; radius += 60)
+        {
+            double a = deg10 / 10.0 * M_PI / 180.0;
+            int32_t x = (int32_t)lround(radius * cos(a)), y = (int32_t)lround(radius * sin(a));
+            double exact = atan2(y, x) * 180.0 / M_PI;
+            double got = touch_gesture_angle(x, y) * 360.0 / 65536.0;
+            double err = fabs(remainder(got - exact, 360.0));
+            if (err > worst)
+                worst = err;
+        }
+    }
+    int angle_ok = worst < 0.3;
+    printf("%-22s worst error %.3f degrees  %s\n", "angle", worst, angle_ok ? "ok" : "MISMATCH");
+    failures += !angle_ok;
+
+    printf("%s\n", failures ? "selftest FAILED" : "selftest passed");
+    return failures;
+}
+
+static int replay_file(const char *path, int verbose)
+{
+    trace_t tr = {0};
+    if (!load_trace(path, &tr))
+        return -1;
+    result_t r = replay(&tr, verbose);
+    int errors = check(path, &tr, &r);
+    free(tr.samples);
+    return errors;
+}
+
+static int cmp_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Every *.txt in dir, in name order; returns the number of traces or -1
+static int replay_dir(const char *dir, int verbose, int *errors)
+{
+    DIR *d = opendir(dir);
+    if (!d)
+    {
+        perror(dir);
+        return -1;
+    }
+    char *names[256];
+    int count = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) && count < 256)
+    {
+        size_t len = strlen(e->d_name);
+        if (len > 4 && strcmp(e->d_name + len - 4, ".txt") == 0)
+        {
+            names[count] = malloc(strlen(dir) + len + 2);
+            sprintf(names[count++], "%s/%s", dir, e->d_name);
+        }
+    }
+    closedir(d);
+    qsort(names, count, sizeof(names[0]), cmp_names);
+
+    int files = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int result = replay_file(names[i], verbose);
+        free(names[i]);
+        if (result < 0)
+            return -1;
+        *errors += result;
+        files++;
+    }
+    return files;
+}
+
+int main(int argc, char **argv)
+{
+    int verbose = 0, errors = 0, files = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--selftest") == 0)
+            return selftest() ? 1 : 0;
+        if (strcmp(argv[i], "-v") == 0)
+        {
+            verbose = 1;
+            continue;
+        }
+
+        struct stat st;
+        if (stat(argv[i], &st) == 0 && S_ISDIR(st.st_mode))
+        {
+            int n = replay_dir(argv[i], verbose, &errors);
+            if (n < 0)
+                return 2;
+            files += n;
+            continue;
+        }
+
+        int result = replay_file(argv[i], verbose);
+        if (result < 0)
+            return 2;
+        errors += result;
+        files++;
+    }
+    if (!files)
+    {
+        fprintf(stderr, "usage: %s [-v] trace.txt|dir...\n"
+                        "       %s --selftest\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+    return errors ? 1 : 0;
+}